@@ -0,0 +1,226 @@
+#include <rtthread.h>
+#include <finsh.h>
+
+#include "claim_policy.h"
+#include "seat_db.h"
+#include "mem_pool.h"
+
+#define DBG_TAG "claim"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+#define WHEEL_MASK      (SEAT_CLAIM_WHEEL_SLOTS - 1)
+#define NODE_NIL        0xFFFF
+
+/* 超时换算为时间轮格数，至少1格 */
+#define CLAIM_TIMEOUT_TICKS \
+    ((SEAT_CLAIM_TIMEOUT_SEC * 1000UL + SEAT_CLAIM_WHEEL_TICK_MS - 1) / SEAT_CLAIM_WHEEL_TICK_MS)
+
+#if (SEAT_CLAIM_WHEEL_SLOTS & WHEEL_MASK) != 0
+#error "SEAT_CLAIM_WHEEL_SLOTS must be a power of two"
+#endif
+
+/* 每个座位ID一个节点，按槽组成双向链表，挂入/撤销均为O(1) */
+typedef struct {
+    rt_uint16_t next;
+    rt_uint16_t prev;
+    rt_uint16_t slot;
+    rt_uint16_t rounds;         // 还需绕轮的圈数
+    rt_uint8_t armed;
+} claim_node_t;
+
+static claim_node_t nodes[SEAT_ID_LIMIT];
+static rt_uint16_t wheel[SEAT_CLAIM_WHEEL_SLOTS];
+static rt_uint32_t cursor;
+/* 已到期待处理的座位，时间轮推进时置位，处理时在持有seat_db.lock的情况下清除 */
+static rt_uint32_t expired_map[SEAT_BITMAP_WORDS(SEAT_ID_LIMIT)];
+
+static struct rt_mutex claim_lock;
+static claim_policy_stats_t stats;
+static mem_pool_t claim_wheel_pool;
+
+static struct rt_thread claim_thread;
+ALIGN(RT_ALIGN_SIZE) static rt_uint8_t claim_thread_stack[1024];
+
+static void node_link(rt_uint16_t id, rt_uint32_t delta)
+{
+    claim_node_t *node = &nodes[id];
+    rt_uint16_t slot = (cursor + delta) & WHEEL_MASK;
+
+    node->slot = slot;
+    node->rounds = (delta - 1) / SEAT_CLAIM_WHEEL_SLOTS;
+    node->prev = NODE_NIL;
+    node->next = wheel[slot];
+    if (node->next != NODE_NIL) {
+        nodes[node->next].prev = id;
+    }
+    wheel[slot] = id;
+    node->armed = 1;
+}
+
+static void node_unlink(rt_uint16_t id)
+{
+    claim_node_t *node = &nodes[id];
+
+    if (node->prev != NODE_NIL) {
+        nodes[node->prev].next = node->next;
+    } else {
+        wheel[node->slot] = node->next;
+    }
+    if (node->next != NODE_NIL) {
+        nodes[node->next].prev = node->prev;
+    }
+    node->armed = 0;
+}
+
+void claim_policy_on_transition(rt_uint16_t seat_id, SeatStatus old_status, SeatStatus new_status)
+{
+    if (seat_id >= SEAT_ID_LIMIT || old_status == new_status) {
+        return;
+    }
+
+    rt_mutex_take(&claim_lock, RT_WAITING_FOREVER);
+    if (new_status == SEAT_CLAIMED) {
+        if (!nodes[seat_id].armed) {
+            node_link(seat_id, CLAIM_TIMEOUT_TICKS);
+            stats.armed++;
+            stats.armed_total++;
+        }
+    } else if (nodes[seat_id].armed) {
+        node_unlink(seat_id);
+        stats.armed--;
+        stats.cancelled++;
+    }
+    /* 任何变迁都使之前的到期标记失效 */
+    seat_bitmap_clear(expired_map, seat_id);
+    mem_pool_note_usage(&claim_wheel_pool, stats.armed);
+    rt_mutex_release(&claim_lock);
+}
+
+/* 处理已到期座位：先取seat_db.lock再取claim_lock，与写入方加锁顺序一致 */
+static void claim_expire_pending(void)
+{
+    rt_uint16_t ids[16];
+    rt_uint32_t n;
+
+    do {
+        rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+
+        rt_mutex_take(&claim_lock, RT_WAITING_FOREVER);
+        n = seat_bitmap_find_first_n(expired_map, 0, SEAT_ID_LIMIT, ids, RT_ARRAY_SIZE(ids));
+        for (rt_uint32_t i = 0; i < n; i++) {
+            seat_bitmap_clear(expired_map, ids[i]);
+        }
+        rt_mutex_release(&claim_lock);
+
+        for (rt_uint32_t i = 0; i < n; i++) {
+            SeatInfo *seat = db_get_seat(ids[i]);
+            if (seat == RT_NULL || seat->status != SEAT_CLAIMED) {
+                continue;
+            }
+#ifdef SEAT_CLAIM_EXPIRE_TO_AVAILABLE
+            LOG_I("Seat %d claim expired, released", ids[i]);
+            db_update_seat_status(ids[i], SEAT_AVAILABLE);
+#else
+            LOG_I("Seat %d claim expired", ids[i]);
+            db_set_seat_flags(ids[i], SEAT_FLAG_CLAIM_EXPIRED);
+#endif
+        }
+
+        rt_mutex_release(seat_db.lock);
+    } while (n == RT_ARRAY_SIZE(ids));
+}
+
+void claim_policy_advance(rt_uint32_t n)
+{
+    rt_bool_t has_expired = RT_FALSE;
+
+    while (n--) {
+        rt_uint16_t id, next;
+
+        rt_mutex_take(&claim_lock, RT_WAITING_FOREVER);
+        cursor++;
+        stats.wheel_ticks++;
+
+        /* 只遍历当前槽，未到期的节点减少一圈 */
+        for (id = wheel[cursor & WHEEL_MASK]; id != NODE_NIL; id = next) {
+            next = nodes[id].next;
+            if (nodes[id].rounds > 0) {
+                nodes[id].rounds--;
+                continue;
+            }
+            node_unlink(id);
+            seat_bitmap_set(expired_map, id);
+            stats.armed--;
+            stats.expired++;
+            has_expired = RT_TRUE;
+        }
+        mem_pool_note_usage(&claim_wheel_pool, stats.armed);
+        rt_mutex_release(&claim_lock);
+    }
+
+    if (has_expired) {
+        claim_expire_pending();
+    }
+}
+
+void claim_policy_get_stats(claim_policy_stats_t *out)
+{
+    rt_mutex_take(&claim_lock, RT_WAITING_FOREVER);
+    *out = stats;
+    rt_mutex_release(&claim_lock);
+}
+
+static void claim_thread_entry(void *param)
+{
+    rt_tick_t last = rt_tick_get();
+    const rt_tick_t period = rt_tick_from_millisecond(SEAT_CLAIM_WHEEL_TICK_MS);
+
+    while (1) {
+        rt_thread_mdelay(SEAT_CLAIM_WHEEL_TICK_MS);
+
+        /* 按实际流逝时间推进，避免延时误差累积 */
+        rt_tick_t elapsed = rt_tick_get() - last;
+        if (elapsed >= period) {
+            claim_policy_advance(elapsed / period);
+            last += (elapsed / period) * period;
+        }
+    }
+}
+
+int claim_policy_init(void)
+{
+    rt_memset(nodes, 0, sizeof(nodes));
+    rt_memset(wheel, 0xFF, sizeof(wheel));
+    rt_memset(expired_map, 0, sizeof(expired_map));
+    rt_memset(&stats, 0, sizeof(stats));
+    cursor = 0;
+
+    rt_mutex_init(&claim_lock, "claim", RT_IPC_FLAG_PRIO);
+    mem_pool_register(&claim_wheel_pool, "claim_wheel", sizeof(claim_node_t), SEAT_ID_LIMIT);
+
+    if (rt_thread_init(&claim_thread, "claim", claim_thread_entry, RT_NULL,
+                       claim_thread_stack, sizeof(claim_thread_stack),
+                       RT_THREAD_PRIORITY_MAX - 4, 10) != RT_EOK) {
+        LOG_E("Claim policy thread init failed");
+        return -RT_ERROR;
+    }
+    rt_thread_startup(&claim_thread);
+
+    LOG_I("Claim policy started, timeout %d s", SEAT_CLAIM_TIMEOUT_SEC);
+    return RT_EOK;
+}
+
+static void claim_stat(int argc, char **argv)
+{
+    claim_policy_stats_t s;
+
+    claim_policy_get_stats(&s);
+    rt_kprintf("Claim timeout    : %d s\n", SEAT_CLAIM_TIMEOUT_SEC);
+    rt_kprintf("Armed claims     : %d\n", s.armed);
+    rt_kprintf("Armed total      : %d\n", s.armed_total);
+    rt_kprintf("Cancelled        : %d\n", s.cancelled);
+    rt_kprintf("Expired          : %d\n", s.expired);
+    rt_kprintf("Wheel ticks      : %d\n", s.wheel_ticks);
+}
+MSH_CMD_EXPORT(claim_stat, show claim timeout policy statistics);
@@ -0,0 +1,39 @@
+#ifndef __CLAIM_POLICY_H__
+#define __CLAIM_POLICY_H__
+
+#include <rtthread.h>
+#include "status_manager.h"
+
+/* 占座超时策略：座位进入SEAT_CLAIMED时挂入时间轮，离开时撤销 */
+#ifndef SEAT_CLAIM_TIMEOUT_SEC
+#define SEAT_CLAIM_TIMEOUT_SEC      1800
+#endif
+
+#ifndef SEAT_CLAIM_WHEEL_TICK_MS
+#define SEAT_CLAIM_WHEEL_TICK_MS    1000
+#endif
+
+/* 时间轮槽数，须为2的幂 */
+#ifndef SEAT_CLAIM_WHEEL_SLOTS
+#define SEAT_CLAIM_WHEEL_SLOTS      64
+#endif
+
+typedef struct {
+    rt_uint32_t armed;          // 当前挂起的占座数
+    rt_uint32_t armed_total;    // 累计挂入次数
+    rt_uint32_t cancelled;      // 离开占座状态而撤销的次数
+    rt_uint32_t expired;        // 超时次数
+    rt_uint32_t wheel_ticks;    // 时间轮推进次数
+} claim_policy_stats_t;
+
+int claim_policy_init(void);
+
+/* 座位状态变迁通知，由数据库写入方在持有seat_db.lock时调用 */
+void claim_policy_on_transition(rt_uint16_t seat_id, SeatStatus old_status, SeatStatus new_status);
+
+/* 推进时间轮n格并处理到期座位，策略线程按SEAT_CLAIM_WHEEL_TICK_MS调用，模拟器可直接驱动 */
+void claim_policy_advance(rt_uint32_t n);
+
+void claim_policy_get_stats(claim_policy_stats_t *stats);
+
+#endif
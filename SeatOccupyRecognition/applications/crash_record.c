@@ -0,0 +1,214 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <board.h>
+#include <finsh.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "crash_record.h"
+
+#define DBG_TAG "crash"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+#define CRASH_RECORD_MAGIC  0x43525348  // "CRSH"
+
+#if SEAT_CRASH_TRANSITIONS > SEAT_TELEMETRY_DEPTH
+#error "SEAT_CRASH_TRANSITIONS must not exceed SEAT_TELEMETRY_DEPTH"
+#endif
+
+/* 启动代码不清零该段，上电后内容随机，靠魔数和校验和识别有效记录 */
+static crash_record_t crash_record RT_SECTION(".noinit");
+
+static const char *const crash_reason_names[] = {
+    "none",
+    "soft watchdog",
+    "cpu fault",
+    "manual",
+};
+
+static rt_uint32_t crash_record_sum(const crash_record_t *rec)
+{
+    const rt_uint32_t *p = (const rt_uint32_t *)rec;
+    rt_uint32_t sum = 0;
+
+    for (rt_uint32_t i = 0; i < offsetof(crash_record_t, checksum) / sizeof(rt_uint32_t); i++) {
+        sum = ((sum << 1) | (sum >> 31)) ^ p[i];
+    }
+    return sum;
+}
+
+static void crash_record_seal(void)
+{
+    crash_record.checksum = crash_record_sum(&crash_record);
+}
+
+/* 线程初始化时栈以'#'填充，栈向下生长，低地址端仍为'#'的部分从未被使用 */
+static rt_uint16_t thread_stack_max_used(struct rt_thread *thread)
+{
+    rt_uint8_t *ptr = (rt_uint8_t *)thread->stack_addr;
+    rt_uint8_t *end = ptr + thread->stack_size;
+
+    while (ptr < end && *ptr == '#') {
+        ptr++;
+    }
+    return (rt_uint16_t)(end - ptr);
+}
+
+void crash_record_capture(crash_reason_t reason, const char *channel, rt_tick_t last_feed)
+{
+    struct rt_object_information *info;
+    struct rt_list_node *node;
+    rt_uint32_t n, total;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+
+    crash_record.reason = reason;
+    crash_record.tick = rt_tick_get();
+    crash_record.last_feed = last_feed;
+    rt_memset(crash_record.channel, 0, sizeof(crash_record.channel));
+    if (channel) {
+        rt_strncpy(crash_record.channel, channel, RT_NAME_MAX);
+    }
+
+    /* 各线程栈高水位 */
+    n = 0;
+    info = rt_object_get_information(RT_Object_Class_Thread);
+    for (node = info->object_list.next; node != &info->object_list && n < SEAT_CRASH_THREADS;
+         node = node->next) {
+        struct rt_thread *thread = rt_list_entry(node, struct rt_thread, list);
+        crash_thread_t *t = &crash_record.threads[n++];
+
+        rt_strncpy(t->name, thread->name, RT_NAME_MAX);
+        t->stack_size = (rt_uint16_t)thread->stack_size;
+        t->max_used = thread_stack_max_used(thread);
+    }
+    crash_record.thread_count = n;
+
+    /* 最近的座位变迁；不取seat_db.lock，超时的线程可能正持有该锁 */
+    total = seat_db.history_total;
+    n = total < SEAT_CRASH_TRANSITIONS ? total : SEAT_CRASH_TRANSITIONS;
+    for (rt_uint32_t i = 0; i < n; i++) {
+        crash_record.transitions[i] = seat_db.history[(total - n + i) % SEAT_TELEMETRY_DEPTH];
+    }
+    crash_record.transition_count = n;
+
+    crash_record.crash_count++;
+    crash_record_seal();
+
+    rt_hw_interrupt_enable(level);
+}
+
+/* CPU异常时记录出错线程，返回错误让默认处理继续打印寄存器 */
+static rt_err_t crash_exception_hook(void *context)
+{
+    rt_thread_t self = rt_thread_self();
+
+    crash_record_capture(CRASH_REASON_FAULT, self ? self->name : RT_NULL, 0);
+    return -RT_ERROR;
+}
+
+void crash_record_init(void)
+{
+    rt_uint32_t flags = 0;
+
+#ifdef SOC_FAMILY_STM32
+    /* 读取并清除复位标志，下次复位的标志才不会与本次叠加 */
+    flags = RCC->CSR;
+    RCC->CSR |= RCC_CSR_RMVF;
+#endif
+
+    if (crash_record.magic != CRASH_RECORD_MAGIC ||
+        crash_record.checksum != crash_record_sum(&crash_record)) {
+        rt_memset(&crash_record, 0, sizeof(crash_record));
+        crash_record.magic = CRASH_RECORD_MAGIC;
+    }
+
+    crash_record.boot_count++;
+    crash_record.reset_flags = flags;
+#ifdef SOC_FAMILY_STM32
+    if (flags & RCC_CSR_IWDGRSTF) {
+        crash_record.iwdg_resets++;
+    }
+#endif
+    crash_record_seal();
+
+    rt_hw_exception_install(crash_exception_hook);
+
+    if (crash_record.reason != CRASH_REASON_NONE) {
+        LOG_W("Crash record present: %s (%.*s), see crash_info",
+              crash_reason_names[crash_record.reason], RT_NAME_MAX, crash_record.channel);
+    }
+}
+
+const crash_record_t *crash_record_get(void)
+{
+    return &crash_record;
+}
+
+static void crash_print_flags(rt_uint32_t flags)
+{
+    rt_kprintf("Reset flags  : 0x%08x", flags);
+#ifdef SOC_FAMILY_STM32
+    if (flags & RCC_CSR_LPWRRSTF) rt_kprintf(" LPWR");
+    if (flags & RCC_CSR_WWDGRSTF) rt_kprintf(" WWDG");
+    if (flags & RCC_CSR_IWDGRSTF) rt_kprintf(" IWDG");
+    if (flags & RCC_CSR_SFTRSTF)  rt_kprintf(" SOFT");
+    if (flags & RCC_CSR_PORRSTF)  rt_kprintf(" POR");
+    if (flags & RCC_CSR_PINRSTF)  rt_kprintf(" PIN");
+    if (flags & RCC_CSR_BORRSTF)  rt_kprintf(" BOR");
+#endif
+    rt_kprintf("\n");
+}
+
+/* MSH命令：解码复位前现场 crash_info [clear|reset] */
+static void crash_info(int argc, char **argv)
+{
+    crash_record_t *rec = &crash_record;
+
+    if (argc > 1 && strcmp(argv[1], "clear") == 0) {
+        rec->reason = CRASH_REASON_NONE;
+        crash_record_seal();
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        crash_record_capture(CRASH_REASON_MANUAL, "msh", 0);
+        rt_hw_cpu_reset();
+        return;
+    }
+
+    rt_kprintf("Boot count   : %d\n", rec->boot_count);
+    rt_kprintf("Crash count  : %d\n", rec->crash_count);
+    rt_kprintf("IWDG resets  : %d\n", rec->iwdg_resets);
+    crash_print_flags(rec->reset_flags);
+
+    if (rec->reason == CRASH_REASON_NONE || rec->reason >= RT_ARRAY_SIZE(crash_reason_names)) {
+        rt_kprintf("No crash record\n");
+        return;
+    }
+
+    rt_kprintf("Last record  : %s at tick %d\n", crash_reason_names[rec->reason], rec->tick);
+    if (rec->channel[0] != '\0') {
+        rt_kprintf("Channel      : %.*s\n", RT_NAME_MAX, rec->channel);
+    }
+    if (rec->reason == CRASH_REASON_SOFT_WDT) {
+        rt_kprintf("Last feed    : tick %d (%d ms before record)\n", rec->last_feed,
+                   (rec->tick - rec->last_feed) * 1000 / RT_TICK_PER_SECOND);
+    }
+
+    rt_kprintf("%-*s  stack  max used\n", RT_NAME_MAX, "thread");
+    for (int i = 0; i < rec->thread_count && i < SEAT_CRASH_THREADS; i++) {
+        crash_thread_t *t = &rec->threads[i];
+        rt_kprintf("%-*.*s  %5d  %5d (%d%%)\n", RT_NAME_MAX, RT_NAME_MAX, t->name,
+                   t->stack_size, t->max_used,
+                   t->stack_size ? t->max_used * 100 / t->stack_size : 0);
+    }
+
+    rt_kprintf("Recent transitions:\n");
+    for (int i = 0; i < rec->transition_count && i < SEAT_CRASH_TRANSITIONS; i++) {
+        SeatTransition *t = &rec->transitions[i];
+        rt_kprintf("  seat %3d  %d -> %d  tick %d\n", t->seat_id, t->old_status, t->new_status, t->tick);
+    }
+}
+MSH_CMD_EXPORT(crash_info, decode retained crash record: crash_info [clear|reset]);
@@ -0,0 +1,59 @@
+#ifndef __CRASH_RECORD_H__
+#define __CRASH_RECORD_H__
+
+#include <rtthread.h>
+#include "seat_db.h"
+
+/* 复位前现场记录，存放在.noinit段（CCM RAM2），软件复位与看门狗复位后保留 */
+
+#ifndef SEAT_CRASH_THREADS
+#define SEAT_CRASH_THREADS      16      // 记录栈高水位的线程数上限
+#endif
+
+#ifndef SEAT_CRASH_TRANSITIONS
+#define SEAT_CRASH_TRANSITIONS  8       // 记录最近的座位状态变迁条数
+#endif
+
+typedef enum {
+    CRASH_REASON_NONE = 0,      // 无现场记录
+    CRASH_REASON_SOFT_WDT,      // 心跳通道超时，软件看门狗复位
+    CRASH_REASON_FAULT,         // CPU异常
+    CRASH_REASON_MANUAL,        // msh命令手动触发
+} crash_reason_t;
+
+typedef struct {
+    char name[RT_NAME_MAX];
+    rt_uint16_t stack_size;
+    rt_uint16_t max_used;       // 栈使用高水位（字节）
+} crash_thread_t;
+
+typedef struct {
+    rt_uint32_t magic;
+    /* 跨复位累计的计数 */
+    rt_uint32_t boot_count;
+    rt_uint32_t crash_count;    // 已记录的现场次数
+    rt_uint32_t iwdg_resets;    // 独立看门狗复位次数
+    rt_uint32_t reset_flags;    // 本次启动读取的RCC_CSR复位标志
+
+    /* 最近一次复位前的现场，reason为NONE表示无记录 */
+    rt_uint8_t reason;
+    rt_uint8_t thread_count;
+    rt_uint8_t transition_count;
+    char channel[RT_NAME_MAX];  // 超时的心跳通道
+    rt_tick_t last_feed;        // 该通道最后一次心跳时刻
+    rt_tick_t tick;             // 记录时刻
+    crash_thread_t threads[SEAT_CRASH_THREADS];
+    SeatTransition transitions[SEAT_CRASH_TRANSITIONS];
+
+    rt_uint32_t checksum;
+} crash_record_t;
+
+/* 启动早期调用：校验保留记录，更新启动计数并读取复位原因 */
+void crash_record_init(void);
+
+/* 复位前记录现场，可在线程、定时器或异常上下文调用 */
+void crash_record_capture(crash_reason_t reason, const char *channel, rt_tick_t last_feed);
+
+const crash_record_t *crash_record_get(void);
+
+#endif
@@ -1,20 +1,236 @@
 #include <rtthread.h>
+#include <finsh.h>
 #include <stdlib.h>
+#include <string.h>
+
 #include "data_simulator.h"
-#include "status_manager.h"
+#include "seat_ingest.h"
+#include "seat_scenario.h"
+#include "seat_db.h"
+
+#define DBG_TAG "sim"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+/* 场景模式的推进步长（实际时间） */
+#define SIM_STEP_MS         100
+/* 单次唤醒最多补发的数据报，落后更多时计入behind并重新对齐 */
+#define SIM_MAX_CATCHUP     64
+
+static struct rt_thread sim_thread;
+ALIGN(RT_ALIGN_SIZE) static rt_uint8_t sim_thread_stack[1536];
+static struct rt_semaphore sim_sem;
+static rt_bool_t sim_inited = RT_FALSE;
+
+static volatile sim_mode_t sim_mode = SIM_MODE_OFF;
+static volatile rt_bool_t sim_busy = RT_FALSE;   // 线程仍在上一次运行中
+static sim_stats_t sim_stats;
+static rt_uint32_t sim_seq;
+static rt_uint32_t sim_rand_state = 0x5EA7;
+
+static rt_uint32_t sim_rand(rt_uint32_t n)
+{
+    sim_rand_state = sim_rand_state * 1103515245 + 12345;
+    return (sim_rand_state >> 8) % n;
+}
+
+/* 与识别板相同的数据报格式，经接收线程同一入口解析入库 */
+static void sim_emit(char *datagram, rt_uint16_t board, void *arg)
+{
+    seat_ingest_datagram(datagram, 0, SIM_PORT_BASE + board);
+    sim_stats.datagrams++;
+}
+
+static void sim_send_uniform(void)
+{
+    static char buf[384];  // 一帧批量数据，只有模拟线程使用，不占线程栈
+    rt_size_t len = rt_snprintf(buf, sizeof(buf), "#%d;", sim_seq++);
+
+    for (rt_uint16_t i = 0; i < sim_stats.records; i++) {
+        int n = rt_snprintf(buf + len, sizeof(buf) - len, i ? ";A%02d:%d" : "A%02d:%d",
+                            1 + sim_rand(SEAT_DB_MAX_SEATS), sim_rand(SEAT_STATUS_NUM));
+        if (n <= 0 || len + n >= sizeof(buf)) {
+            break;
+        }
+        len += n;
+    }
+    sim_emit(buf, 0, RT_NULL);
+}
+
+/* 固定速率：第k个数据报在start + k/rate秒到期，每次唤醒发出全部已到期的 */
+static void sim_run_uniform(void)
+{
+    rt_uint64_t sent = 0;
+    rt_tick_t start = rt_tick_get();
+
+    while (sim_mode == SIM_MODE_UNIFORM) {
+        rt_tick_t now = rt_tick_get();
+        rt_uint64_t due = (rt_uint64_t)(now - start) * sim_stats.rate / RT_TICK_PER_SECOND + 1;
+
+        if (due - sent > SIM_MAX_CATCHUP) {
+            sim_stats.behind += due - sent - SIM_MAX_CATCHUP;
+            sent = due - SIM_MAX_CATCHUP;
+        }
+        while (sent < due) {
+            sim_send_uniform();
+            sent++;
+        }
+
+        /* 睡到下一个数据报到期，至少一个滴答 */
+        rt_tick_t next = start + (rt_tick_t)(sent * RT_TICK_PER_SECOND / sim_stats.rate);
+        rt_int32_t wait = (rt_int32_t)(next - rt_tick_get());
+        rt_thread_delay(wait > 0 ? wait : 1);
+    }
+}
+
+/* 场景模式：每SIM_STEP_MS实际时间推进speed倍的场景时间，跑完一天后停止 */
+static void sim_run_scenario(void)
+{
+    rt_uint32_t length = seat_scenario_length_ms();
+    rt_uint32_t now = 0;
+
+    while (sim_mode == SIM_MODE_SCENARIO && now <= length) {
+        seat_scenario_step(now);
+        now += SIM_STEP_MS * sim_stats.speed;
+        rt_thread_mdelay(SIM_STEP_MS);
+    }
+    if (sim_mode == SIM_MODE_SCENARIO) {
+        LOG_I("Scenario finished, %d datagrams", sim_stats.datagrams);
+        sim_mode = SIM_MODE_OFF;
+    }
+}
 
-static rt_timer_t sim_timer;
+static void sim_thread_entry(void *param)
+{
+    while (1) {
+        rt_sem_take(&sim_sem, RT_WAITING_FOREVER);
 
-/* 模拟数据生成 */
-static void simulate_data(void *param) {
-    uint8_t seat_id = rand() % MAX_SEATS;
-    uint8_t status = rand() % 3;
-    update_seat(seat_id, status); // 自动遵守静默模式设置
+        sim_busy = RT_TRUE;
+        if (sim_mode == SIM_MODE_UNIFORM) {
+            sim_run_uniform();
+        } else if (sim_mode == SIM_MODE_SCENARIO) {
+            sim_run_scenario();
+        }
+        sim_busy = RT_FALSE;
+    }
 }
 
-/* 数据模拟器初始化 */
-void data_simulator_init(void) {
-    sim_timer = rt_timer_create("sim", simulate_data, NULL,
-                              2000, RT_TIMER_FLAG_PERIODIC);
-    if(sim_timer) rt_timer_start(sim_timer);
+rt_err_t data_simulator_init(void)
+{
+    if (sim_inited) {
+        return RT_EOK;
+    }
+
+    rt_sem_init(&sim_sem, "sim", 0, RT_IPC_FLAG_PRIO);
+    /* 与UDP接收线程同优先级，注入路径的调度行为与网络接收一致 */
+    if (rt_thread_init(&sim_thread, "sim", sim_thread_entry, RT_NULL,
+                       sim_thread_stack, sizeof(sim_thread_stack),
+                       RT_THREAD_PRIORITY_MAX / 2, 20) != RT_EOK) {
+        LOG_E("Simulator thread init failed");
+        return -RT_ERROR;
+    }
+    rt_thread_startup(&sim_thread);
+    sim_inited = RT_TRUE;
+    return RT_EOK;
+}
+
+static rt_err_t sim_start(sim_mode_t mode)
+{
+    if (!sim_inited) {
+        return -RT_ERROR;
+    }
+    if (sim_mode != SIM_MODE_OFF || sim_busy) {
+        return -RT_EBUSY;
+    }
+
+    sim_stats.mode = mode;
+    sim_stats.datagrams = 0;
+    sim_stats.behind = 0;
+    sim_stats.start_tick = rt_tick_get();
+    sim_mode = mode;
+    rt_sem_release(&sim_sem);
+    return RT_EOK;
+}
+
+rt_err_t data_simulator_start_uniform(rt_uint32_t rate, rt_uint16_t records)
+{
+    if (rate == 0 || records == 0 || records > SEAT_INGEST_FRAME_MAX) {
+        return -RT_EINVAL;
+    }
+    if (sim_mode != SIM_MODE_OFF || sim_busy) {
+        return -RT_EBUSY;
+    }
+    sim_stats.rate = rate;
+    sim_stats.records = records;
+    return sim_start(SIM_MODE_UNIFORM);
+}
+
+rt_err_t data_simulator_start_scenario(rt_uint16_t speed)
+{
+    if (speed == 0) {
+        return -RT_EINVAL;
+    }
+    if (sim_mode != SIM_MODE_OFF || sim_busy) {
+        return -RT_EBUSY;
+    }
+    if (seat_scenario_init(&seat_scenario_library_day, SEAT_SCN_MAX_SEATS, 30, rt_tick_get(),
+                           sim_emit, RT_NULL) != RT_EOK) {
+        return -RT_EINVAL;
+    }
+    sim_stats.speed = speed;
+    return sim_start(SIM_MODE_SCENARIO);
+}
+
+void data_simulator_stop(void)
+{
+    sim_mode = SIM_MODE_OFF;
+}
+
+rt_bool_t data_simulator_running(void)
+{
+    return sim_mode != SIM_MODE_OFF;
+}
+
+void data_simulator_get_stats(sim_stats_t *out)
+{
+    *out = sim_stats;
+    out->mode = sim_mode;
+}
+
+static void sim(int argc, char **argv)
+{
+    rt_err_t err = RT_EOK;
+
+    if (argc > 2 && strcmp(argv[1], "uniform") == 0) {
+        err = data_simulator_start_uniform(atoi(argv[2]), argc > 3 ? atoi(argv[3]) : 1);
+    } else if (argc > 1 && strcmp(argv[1], "scenario") == 0) {
+        err = data_simulator_start_scenario(argc > 2 ? atoi(argv[2]) : 60);
+    } else if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        data_simulator_stop();
+    } else if (argc > 1 && strcmp(argv[1], "stat") == 0) {
+        static const char *const modes[] = { "off", "uniform", "scenario" };
+        rt_uint32_t elapsed_ms = (rt_tick_get() - sim_stats.start_tick) * 1000 / RT_TICK_PER_SECOND;
+
+        rt_kprintf("Mode      : %s\n", modes[sim_mode]);
+        if (sim_stats.mode == SIM_MODE_UNIFORM) {
+            rt_kprintf("Offered   : %d datagram/s, %d records each\n", sim_stats.rate, sim_stats.records);
+        } else if (sim_stats.mode == SIM_MODE_SCENARIO) {
+            rt_kprintf("Speed     : %dx real time\n", sim_stats.speed);
+        }
+        rt_kprintf("Datagrams : %d\n", sim_stats.datagrams);
+        rt_kprintf("Achieved  : %d datagram/s\n",
+                   elapsed_ms ? (rt_uint32_t)((rt_uint64_t)sim_stats.datagrams * 1000 / elapsed_ms) : 0);
+        rt_kprintf("Behind    : %d\n", sim_stats.behind);
+        return;
+    } else {
+        rt_kprintf("Usage: sim uniform <rate> [records] | scenario [speed] | stop | stat\n");
+        return;
+    }
+
+    if (err == -RT_EBUSY) {
+        rt_kprintf("Simulator already running, use sim stop first\n");
+    } else if (err != RT_EOK) {
+        rt_kprintf("Invalid simulator parameters\n");
+    }
 }
+MSH_CMD_EXPORT(sim, in-process ingest simulator: sim uniform <rate> [records] | scenario [speed] | stop | stat);
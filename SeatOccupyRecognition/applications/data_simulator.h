@@ -2,10 +2,39 @@
 #define __DATA_SIMULATOR_H__
 
 #include <rtthread.h>
-#include "status_manager.h"
 
-extern struct rt_messagequeue ui_mq;
+/* 进程内模拟器：不经网络，直接在接收线程调用的入口seat_ingest_datagram注入数据报，
+ * 用于无摄像头、关闭WiFi时在单板上测试数据库与界面 */
 
-void data_simulator_init(void);
+/* 模拟数据报的源端口基数，ingest_stat中按端口区分 */
+#define SIM_PORT_BASE       5000
+
+/* 台架模式下场景相对实时的倍数 */
+#ifndef SEAT_SIM_SCENARIO_SPEED
+#define SEAT_SIM_SCENARIO_SPEED     60
+#endif
+
+typedef enum {
+    SIM_MODE_OFF = 0,
+    SIM_MODE_UNIFORM,           // 固定速率，随机座位与状态
+    SIM_MODE_SCENARIO,          // 按内置场景模拟一天，可加速
+} sim_mode_t;
+
+typedef struct {
+    sim_mode_t mode;
+    rt_uint32_t rate;           // UNIFORM：每秒数据报数
+    rt_uint16_t records;        // UNIFORM：每个数据报的记录数
+    rt_uint16_t speed;          // SCENARIO：相对实时的倍数
+    rt_uint32_t datagrams;      // 已注入的数据报
+    rt_uint32_t behind;         // 跟不上计划速率而跳过的数据报
+    rt_tick_t start_tick;
+} sim_stats_t;
+
+rt_err_t data_simulator_init(void);
+rt_err_t data_simulator_start_uniform(rt_uint32_t rate, rt_uint16_t records);
+rt_err_t data_simulator_start_scenario(rt_uint16_t speed);
+void data_simulator_stop(void);
+rt_bool_t data_simulator_running(void);
+void data_simulator_get_stats(sim_stats_t *out);
 
 #endif
@@ -0,0 +1,199 @@
+#include <rtthread.h>
+#include <string.h>
+#include <finsh.h>
+
+#include "label_cache.h"
+#include "lcd_tile.h"
+#include "mem_pool.h"
+
+#define DBG_TAG "label"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+/* 驱动字库（drv_lcd.c中定义）：可见ASCII字符，每字符size行、每行(size/2+7)/8字节，高位在左 */
+extern const rt_uint8_t asc2_1608[];
+extern const rt_uint8_t asc2_2412[];
+extern const rt_uint8_t asc2_3216[];
+
+typedef struct {
+    const char *text;
+    rt_uint8_t size;
+} label_def_t;
+
+static const label_def_t fixed_labels[LABEL_STATUS_WORD] = {
+    { "Seat Information", 24 },
+    { "Date: 2025-07-05", 16 },
+    { "Status:",          32 },
+};
+
+#define STATUS_WORD_SIZE    32
+
+ALIGN(4) static rt_uint8_t label_arena[SEAT_LABEL_CACHE_SIZE];
+static rt_size_t arena_used;
+static lcd_label_t labels[LABEL_COUNT];
+static mem_pool_t label_pool;
+
+static const rt_uint8_t *font_table(rt_uint8_t size)
+{
+    switch (size) {
+    case 16: return asc2_1608;
+    case 24: return asc2_2412;
+    case 32: return asc2_3216;
+    default: return RT_NULL;
+    }
+}
+
+/* 将字符串逐字拼接为一整块1-bpp位图写入bits，绘制时不再查字库 */
+static rt_err_t label_render(lcd_label_t *label, const char *text, rt_uint8_t size,
+                             rt_uint8_t *bits, rt_size_t cap)
+{
+    const rt_uint8_t *font = font_table(size);
+    rt_uint16_t cw = size / 2;
+    rt_uint16_t glyph_stride = (cw + 7) / 8;
+    rt_uint32_t len = rt_strlen(text);
+
+    if (font == RT_NULL) {
+        return -RT_EINVAL;
+    }
+
+    label->w = len * cw;
+    label->h = size;
+    label->stride = (label->w + 7) / 8;
+    if (label->stride * label->h > cap) {
+        return -RT_ENOMEM;
+    }
+    rt_memset(bits, 0, label->stride * label->h);
+
+    for (rt_uint32_t c = 0; c < len; c++) {
+        rt_uint8_t ch = (rt_uint8_t)text[c];
+        const rt_uint8_t *glyph;
+
+        if (ch < ' ' || ch > '~') {
+            ch = ' ';
+        }
+        glyph = font + (ch - ' ') * glyph_stride * size;
+
+        for (rt_uint16_t row = 0; row < size; row++) {
+            for (rt_uint16_t col = 0; col < cw; col++) {
+                if (glyph[row * glyph_stride + col / 8] & (0x80 >> (col % 8))) {
+                    rt_uint16_t px = c * cw + col;
+                    bits[row * label->stride + px / 8] |= 0x80 >> (px % 8);
+                }
+            }
+        }
+    }
+
+    label->bits = bits;
+    return RT_EOK;
+}
+
+/* 固定标签依次占用缓存区 */
+static rt_err_t label_rasterize(lcd_label_t *label, const char *text, rt_uint8_t size)
+{
+    rt_err_t ret = label_render(label, text, size, &label_arena[arena_used],
+                                sizeof(label_arena) - arena_used);
+
+    if (ret == -RT_ENOMEM) {
+        LOG_E("Label cache full, \"%s\" not cached", text);
+    }
+    if (ret == RT_EOK) {
+        arena_used += label->stride * label->h;
+    }
+    return ret;
+}
+
+rt_err_t label_cache_init(void)
+{
+    rt_err_t ret = RT_EOK;
+
+    arena_used = 0;
+    rt_memset(labels, 0, sizeof(labels));
+
+    for (rt_uint32_t i = 0; i < LABEL_STATUS_WORD; i++) {
+        if (label_rasterize(&labels[i], fixed_labels[i].text, fixed_labels[i].size) != RT_EOK) {
+            ret = -RT_ENOMEM;
+        }
+    }
+    for (rt_uint32_t i = 0; i < SEAT_STATUS_NUM; i++) {
+        if (label_rasterize(&labels[LABEL_STATUS_WORD + i], seat_status_strings[i],
+                            STATUS_WORD_SIZE) != RT_EOK) {
+            ret = -RT_ENOMEM;
+        }
+    }
+
+    mem_pool_register(&label_pool, "label", 1, sizeof(label_arena));
+    mem_pool_note_usage(&label_pool, arena_used);
+    LOG_I("Label cache: %d labels, %d/%d bytes", LABEL_COUNT, (int)arena_used, (int)sizeof(label_arena));
+    return ret;
+}
+
+rt_uint8_t *label_cache_reserve(rt_size_t size)
+{
+    rt_uint8_t *buf;
+
+    if (arena_used + size > sizeof(label_arena)) {
+        LOG_E("Label cache full, %d bytes not reserved", (int)size);
+        return RT_NULL;
+    }
+    buf = &label_arena[arena_used];
+    arena_used += size;
+    mem_pool_note_usage(&label_pool, arena_used);
+    return buf;
+}
+
+rt_err_t label_cache_render(lcd_label_t *label, rt_uint8_t *buf, rt_size_t cap,
+                            const char *text, rt_uint8_t size)
+{
+    rt_err_t ret = label_render(label, text, size, buf, cap);
+
+    if (ret != RT_EOK) {
+        label->bits = RT_NULL;
+    }
+    return ret;
+}
+
+const lcd_label_t *label_cache_get(rt_uint32_t id)
+{
+    if (id >= LABEL_COUNT || labels[id].bits == RT_NULL) {
+        return RT_NULL;
+    }
+    return &labels[id];
+}
+
+rt_uint32_t label_cache_draw(const lcd_label_t *label, rt_uint16_t x, rt_uint16_t y,
+                             rt_uint16_t fg, rt_uint16_t bg)
+{
+    rt_uint16_t band = SEAT_LCD_TILE_PIXELS / label->w;
+    const rt_uint8_t *src = label->bits;
+    rt_uint16_t h = label->h;
+
+    /* 逐行带展开为RGB565写入瓦片，传输与下一行带的展开并行 */
+    while (h) {
+        rt_uint16_t rows = h < band ? h : band;
+        rt_uint16_t *dst = lcd_tile_begin(x, y, label->w, rows);
+
+        for (rt_uint16_t row = 0; row < rows; row++) {
+            for (rt_uint16_t col = 0; col < label->w; col++) {
+                *dst++ = (src[col / 8] & (0x80 >> (col % 8))) ? fg : bg;
+            }
+            src += label->stride;
+        }
+        lcd_tile_submit();
+        y += rows;
+        h -= rows;
+    }
+
+    return (rt_uint32_t)label->w * label->h;
+}
+
+static void label_stat(int argc, char **argv)
+{
+    rt_kprintf("Label cache      : %d/%d bytes\n", (int)arena_used, (int)sizeof(label_arena));
+    for (rt_uint32_t i = 0; i < LABEL_COUNT; i++) {
+        const char *text = i < LABEL_STATUS_WORD ? fixed_labels[i].text
+                                                 : seat_status_strings[i - LABEL_STATUS_WORD];
+        rt_kprintf("  %-18s %3dx%-3d %s\n", text, labels[i].w, labels[i].h,
+                   labels[i].bits ? "cached" : "missing");
+    }
+}
+MSH_CMD_EXPORT(label_stat, show pre-rasterized LCD label cache);
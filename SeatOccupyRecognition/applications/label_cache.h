@@ -0,0 +1,42 @@
+#ifndef __LABEL_CACHE_H__
+#define __LABEL_CACHE_H__
+
+#include <rtthread.h>
+#include "seat_db.h"
+
+/* 预光栅化标签缓存区大小（字节），存放1-bpp位图 */
+#ifndef SEAT_LABEL_CACHE_SIZE
+#define SEAT_LABEL_CACHE_SIZE   7168
+#endif
+
+/* 固定标签编号，状态文字按SeatStatus顺序排在最后 */
+enum {
+    LABEL_TITLE = 0,            // "Seat Information"
+    LABEL_DATE,                 // 日期行
+    LABEL_STATUS,               // "Status:"
+    LABEL_STATUS_WORD,          // seat_status_strings[0]起
+    LABEL_COUNT = LABEL_STATUS_WORD + SEAT_STATUS_NUM,
+};
+
+/* 1-bpp位图，行优先，高位在左 */
+typedef struct {
+    rt_uint16_t w;
+    rt_uint16_t h;
+    rt_uint16_t stride;         // 每行字节数
+    const rt_uint8_t *bits;     // 为RT_NULL表示未缓存
+} lcd_label_t;
+
+/* 启动时从驱动字库光栅化全部固定标签 */
+rt_err_t label_cache_init(void);
+const lcd_label_t *label_cache_get(rt_uint32_t id);
+/* 从缓存区划出一块供调用方反复光栅化（如分页标题），启动阶段调用，失败返回RT_NULL */
+rt_uint8_t *label_cache_reserve(rt_size_t size);
+/* 把标签光栅化到调用方的缓冲区，放不下时返回-RT_ENOMEM且label->bits为RT_NULL */
+rt_err_t label_cache_render(lcd_label_t *label, rt_uint8_t *buf, rt_size_t cap,
+                            const char *text, rt_uint8_t size);
+
+/* 经瓦片缓冲区以前景/背景色绘制标签，返回推送的像素数 */
+rt_uint32_t label_cache_draw(const lcd_label_t *label, rt_uint16_t x, rt_uint16_t y,
+                             rt_uint16_t fg, rt_uint16_t bg);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef __LCD_COLORS_H__
+#define __LCD_COLORS_H__
+
+#include <rtthread.h>
+
+/* RGB565颜色 */
+#define WHITE           0xFFFF
+#define BLACK           0x0000
+#define GREEN           0x07E0
+#define RED             0xF800
+#define YELLOW          0xFFE0
+#define GRAY            0x8410
+#define ORANGE          0xFD20
+
+/* 座位状态颜色映射，按SeatStatus索引 */
+extern rt_uint16_t seat_status_colors[];
+
+#endif
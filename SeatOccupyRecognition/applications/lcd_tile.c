@@ -0,0 +1,309 @@
+#include <rtthread.h>
+#include <string.h>
+#include <finsh.h>
+#include <drv_lcd.h>
+
+#include "lcd_tile.h"
+#include "mem_pool.h"
+
+#define DBG_TAG "lcd.tile"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+/* 双缓冲：compose_idx指向CPU当前合成的缓冲区 */
+ALIGN(4) static rt_uint16_t tile_buf[2][SEAT_LCD_TILE_PIXELS];
+static rt_uint8_t compose_idx;
+static rt_uint16_t win_x1, win_y1, win_x2, win_y2;
+static rt_uint32_t win_count;
+
+/* 传输空闲信号量：初值1，启动传输时取走，传输完成时释放 */
+static struct rt_semaphore tile_idle;
+static const lcd_tile_backend_t *tile_backend = RT_NULL;
+static lcd_tile_stats_t tile_stats;
+static mem_pool_t tile_pool;
+
+void lcd_tile_transfer_done(void)
+{
+    rt_sem_release(&tile_idle);
+}
+
+/* ---------- 同步后端 ---------- */
+
+static rt_err_t sync_start(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2,
+                           const rt_uint16_t *pixels, rt_uint32_t count)
+{
+    lcd_fill_array(x1, y1, x2, y2, (void *)pixels);
+    lcd_tile_transfer_done();
+    return RT_EOK;
+}
+
+const lcd_tile_backend_t lcd_tile_sync_backend = {
+    "sync", RT_NULL, sync_start,
+};
+
+/* ---------- 模拟后端 ---------- */
+
+static lcd_tile_xfer_t mock_log[SEAT_LCD_TILE_MOCK_DEPTH];
+static rt_uint32_t mock_total;
+
+static rt_err_t mock_start(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2,
+                           const rt_uint16_t *pixels, rt_uint32_t count)
+{
+    lcd_tile_xfer_t *xfer = &mock_log[mock_total % SEAT_LCD_TILE_MOCK_DEPTH];
+
+    xfer->x1 = x1;
+    xfer->y1 = y1;
+    xfer->x2 = x2;
+    xfer->y2 = y2;
+    xfer->count = count;
+    xfer->checksum = 0;
+    for (rt_uint32_t i = 0; i < count; i++) {
+        xfer->checksum += pixels[i];
+    }
+    mock_total++;
+
+    lcd_tile_transfer_done();
+    return RT_EOK;
+}
+
+const lcd_tile_backend_t lcd_tile_mock_backend = {
+    "mock", RT_NULL, mock_start,
+};
+
+rt_uint32_t lcd_tile_mock_dump(lcd_tile_xfer_t *out, rt_uint32_t max_n)
+{
+    rt_uint32_t n = mock_total < SEAT_LCD_TILE_MOCK_DEPTH ? mock_total : SEAT_LCD_TILE_MOCK_DEPTH;
+    rt_uint32_t first;
+
+    if (n > max_n) {
+        n = max_n;
+    }
+    first = mock_total - n;
+    for (rt_uint32_t i = 0; i < n; i++) {
+        out[i] = mock_log[(first + i) % SEAT_LCD_TILE_MOCK_DEPTH];
+    }
+    return n;
+}
+
+/* ---------- DMA后端 ---------- */
+
+#ifdef SEAT_LCD_TILE_USING_DMA
+#include <board.h>
+
+/* LCD数据端口地址：FSMC Bank1 NE4，A6接RS */
+#ifndef SEAT_LCD_RAM_ADDR
+#define SEAT_LCD_RAM_ADDR       (0x6C000000 | 0x00000080)
+#endif
+
+static DMA_HandleTypeDef lcd_dma;
+
+static void lcd_dma_cplt(DMA_HandleTypeDef *hdma)
+{
+    lcd_tile_transfer_done();
+}
+
+void DMA2_Stream0_IRQHandler(void)
+{
+    rt_interrupt_enter();
+    HAL_DMA_IRQHandler(&lcd_dma);
+    rt_interrupt_leave();
+}
+
+/* 只有DMA2支持存储器到存储器：外设端口为源（递增），存储器端口为FSMC数据端口（固定） */
+static rt_err_t dma_init(void)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    lcd_dma.Instance = DMA2_Stream0;
+    lcd_dma.Init.Channel = DMA_CHANNEL_0;
+    lcd_dma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    lcd_dma.Init.PeriphInc = DMA_PINC_ENABLE;
+    lcd_dma.Init.MemInc = DMA_MINC_DISABLE;
+    lcd_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    lcd_dma.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    lcd_dma.Init.Mode = DMA_NORMAL;
+    lcd_dma.Init.Priority = DMA_PRIORITY_HIGH;
+    lcd_dma.Init.FIFOMode = DMA_FIFOMODE_ENABLE;
+    lcd_dma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+    lcd_dma.Init.MemBurst = DMA_MBURST_SINGLE;
+    lcd_dma.Init.PeriphBurst = DMA_PBURST_SINGLE;
+    if (HAL_DMA_Init(&lcd_dma) != HAL_OK) {
+        return -RT_ERROR;
+    }
+    HAL_DMA_RegisterCallback(&lcd_dma, HAL_DMA_XFER_CPLT_CB_ID, lcd_dma_cplt);
+
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+    return RT_EOK;
+}
+
+static rt_err_t dma_start(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2,
+                          const rt_uint16_t *pixels, rt_uint32_t count)
+{
+    lcd_address_set(x1, y1, x2, y2);
+    if (HAL_DMA_Start_IT(&lcd_dma, (uint32_t)pixels, SEAT_LCD_RAM_ADDR, count) != HAL_OK) {
+        lcd_tile_transfer_done();
+        return -RT_ERROR;
+    }
+    return RT_EOK;
+}
+
+const lcd_tile_backend_t lcd_tile_dma_backend = {
+    "dma", dma_init, dma_start,
+};
+#endif /* SEAT_LCD_TILE_USING_DMA */
+
+/* ---------- 瓦片合成 ---------- */
+
+rt_err_t lcd_tile_use(const lcd_tile_backend_t *backend)
+{
+    /* 切换前等待旧后端的传输完成 */
+    lcd_tile_sync();
+    if (backend->init && backend->init() != RT_EOK) {
+        LOG_E("LCD backend %s init failed", backend->name);
+        return -RT_ERROR;
+    }
+
+    tile_backend = backend;
+    LOG_I("LCD tile backend: %s", backend->name);
+    return RT_EOK;
+}
+
+rt_err_t lcd_tile_init(const lcd_tile_backend_t *backend)
+{
+    rt_sem_init(&tile_idle, "lcdtile", 1, RT_IPC_FLAG_PRIO);
+    mem_pool_register(&tile_pool, "lcd_tile", sizeof(tile_buf[0]), 2);
+    mem_pool_note_usage(&tile_pool, 2);
+    compose_idx = 0;
+
+    return lcd_tile_use(backend);
+}
+
+rt_uint16_t *lcd_tile_begin(rt_uint16_t x, rt_uint16_t y, rt_uint16_t w, rt_uint16_t h)
+{
+    if (w == 0 || h == 0 || (rt_uint32_t)w * h > SEAT_LCD_TILE_PIXELS) {
+        return RT_NULL;
+    }
+
+    win_x1 = x;
+    win_y1 = y;
+    win_x2 = x + w - 1;
+    win_y2 = y + h - 1;
+    win_count = (rt_uint32_t)w * h;
+    return tile_buf[compose_idx];
+}
+
+rt_err_t lcd_tile_submit(void)
+{
+    rt_tick_t start = rt_tick_get();
+    rt_err_t ret;
+
+    /* 上一块仍在传输时，等待其完成；本块在另一块缓冲区中，不会被覆盖 */
+    if (rt_sem_trytake(&tile_idle) != RT_EOK) {
+        tile_stats.waits++;
+        rt_sem_take(&tile_idle, RT_WAITING_FOREVER);
+        tile_stats.wait_ticks += rt_tick_get() - start;
+    }
+
+    tile_stats.transfers++;
+    tile_stats.pixels += win_count;
+    ret = tile_backend->start(win_x1, win_y1, win_x2, win_y2, tile_buf[compose_idx], win_count);
+
+    compose_idx ^= 1;
+    return ret;
+}
+
+void lcd_tile_sync(void)
+{
+    rt_sem_take(&tile_idle, RT_WAITING_FOREVER);
+    rt_sem_release(&tile_idle);
+}
+
+void lcd_tile_fill_rect(rt_uint16_t x, rt_uint16_t y, rt_uint16_t w, rt_uint16_t h, rt_uint16_t color)
+{
+    rt_uint16_t band = w ? SEAT_LCD_TILE_PIXELS / w : 0;
+
+    if (band == 0) {
+        return;
+    }
+
+    while (h) {
+        rt_uint16_t rows = h < band ? h : band;
+        rt_uint16_t *buf = lcd_tile_begin(x, y, w, rows);
+        rt_uint32_t n = (rt_uint32_t)w * rows;
+
+        for (rt_uint32_t i = 0; i < n; i++) {
+            buf[i] = color;
+        }
+        lcd_tile_submit();
+        y += rows;
+        h -= rows;
+    }
+}
+
+void lcd_tile_blit(rt_uint16_t x, rt_uint16_t y, rt_uint16_t w, rt_uint16_t h, const rt_uint16_t *src)
+{
+    rt_uint16_t band = w ? SEAT_LCD_TILE_PIXELS / w : 0;
+
+    if (band == 0) {
+        return;
+    }
+
+    while (h) {
+        rt_uint16_t rows = h < band ? h : band;
+        rt_uint16_t *buf = lcd_tile_begin(x, y, w, rows);
+        rt_uint32_t n = (rt_uint32_t)w * rows;
+
+        rt_memcpy(buf, src, n * sizeof(rt_uint16_t));
+        lcd_tile_submit();
+        src += n;
+        y += rows;
+        h -= rows;
+    }
+}
+
+void lcd_tile_get_stats(lcd_tile_stats_t *stats)
+{
+    *stats = tile_stats;
+}
+
+static void lcd_tile_stat(int argc, char **argv)
+{
+    rt_kprintf("Backend          : %s\n", tile_backend ? tile_backend->name : "none");
+    rt_kprintf("Tile size        : %d px x 2\n", SEAT_LCD_TILE_PIXELS);
+    rt_kprintf("Transfers        : %d\n", tile_stats.transfers);
+    rt_kprintf("Pixels           : %d\n", tile_stats.pixels);
+    rt_kprintf("Submit waits     : %d (%d ticks)\n", tile_stats.waits, tile_stats.wait_ticks);
+    if (tile_backend == &lcd_tile_mock_backend) {
+        rt_kprintf("Mock transfers   : %d\n", mock_total);
+    }
+}
+MSH_CMD_EXPORT(lcd_tile_stat, show LCD tile transfer statistics);
+
+/* MSH命令：切换传输后端 lcd_backend <sync|mock|dma> */
+static void lcd_backend(int argc, char **argv)
+{
+    const lcd_tile_backend_t *backend = RT_NULL;
+
+    if (argc < 2) {
+        rt_kprintf("Usage: lcd_backend <sync|mock|dma>\n");
+        return;
+    }
+
+    if (strcmp(argv[1], "sync") == 0) {
+        backend = &lcd_tile_sync_backend;
+    } else if (strcmp(argv[1], "mock") == 0) {
+        backend = &lcd_tile_mock_backend;
+#ifdef SEAT_LCD_TILE_USING_DMA
+    } else if (strcmp(argv[1], "dma") == 0) {
+        backend = &lcd_tile_dma_backend;
+#endif
+    }
+
+    if (backend == RT_NULL) {
+        rt_kprintf("Unknown backend: %s\n", argv[1]);
+        return;
+    }
+    lcd_tile_use(backend);
+}
+MSH_CMD_EXPORT(lcd_backend, select LCD tile backend: lcd_backend <sync|mock|dma>);
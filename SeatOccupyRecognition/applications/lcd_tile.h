@@ -0,0 +1,64 @@
+#ifndef __LCD_TILE_H__
+#define __LCD_TILE_H__
+
+#include <rtthread.h>
+
+/* 瓦片缓冲区像素数（RGB565），共两块：CPU合成一块的同时另一块在传输 */
+#ifndef SEAT_LCD_TILE_PIXELS
+#define SEAT_LCD_TILE_PIXELS    2048
+#endif
+
+/* 模拟后端记录的最近传输条数 */
+#ifndef SEAT_LCD_TILE_MOCK_DEPTH
+#define SEAT_LCD_TILE_MOCK_DEPTH    32
+#endif
+
+/* LCD传输后端：start启动一次窗口[x1,x2]x[y1,y2]的像素传输（闭区间），
+ * 传输完成后（可在中断中）调用lcd_tile_transfer_done() */
+typedef struct lcd_tile_backend {
+    const char *name;
+    rt_err_t (*init)(void);
+    rt_err_t (*start)(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2,
+                      const rt_uint16_t *pixels, rt_uint32_t count);
+} lcd_tile_backend_t;
+
+/* 模拟后端的传输记录 */
+typedef struct {
+    rt_uint16_t x1, y1, x2, y2;
+    rt_uint32_t count;
+    rt_uint32_t checksum;       // 像素累加和，用于比对渲染结果
+} lcd_tile_xfer_t;
+
+typedef struct {
+    rt_uint32_t transfers;      // 传输次数
+    rt_uint32_t pixels;         // 传输像素总数
+    rt_uint32_t waits;          // 提交时上一次传输尚未完成的次数
+    rt_tick_t wait_ticks;       // CPU等待传输完成的累计滴答数
+} lcd_tile_stats_t;
+
+extern const lcd_tile_backend_t lcd_tile_sync_backend;     // lcd_fill_array同步传输
+extern const lcd_tile_backend_t lcd_tile_mock_backend;     // 仅记录传输，不访问硬件
+#ifdef SEAT_LCD_TILE_USING_DMA
+extern const lcd_tile_backend_t lcd_tile_dma_backend;      // FSMC + DMA2存储器到存储器
+#endif
+
+rt_err_t lcd_tile_init(const lcd_tile_backend_t *backend);
+rt_err_t lcd_tile_use(const lcd_tile_backend_t *backend);
+
+/* 取得合成缓冲区，w*h不得超过SEAT_LCD_TILE_PIXELS；合成后调用lcd_tile_submit */
+rt_uint16_t *lcd_tile_begin(rt_uint16_t x, rt_uint16_t y, rt_uint16_t w, rt_uint16_t h);
+/* 等待上一块传输完成后启动本块传输，并切换到另一块缓冲区 */
+rt_err_t lcd_tile_submit(void);
+/* 等待所有传输完成，直接调用drv_lcd接口前必须先同步 */
+void lcd_tile_sync(void);
+void lcd_tile_transfer_done(void);
+
+/* 按行带拆分的矩形填充与位图传输 */
+void lcd_tile_fill_rect(rt_uint16_t x, rt_uint16_t y, rt_uint16_t w, rt_uint16_t h, rt_uint16_t color);
+void lcd_tile_blit(rt_uint16_t x, rt_uint16_t y, rt_uint16_t w, rt_uint16_t h, const rt_uint16_t *src);
+
+void lcd_tile_get_stats(lcd_tile_stats_t *stats);
+/* 读取模拟后端的传输记录，返回复制的条数（由旧到新） */
+rt_uint32_t lcd_tile_mock_dump(lcd_tile_xfer_t *out, rt_uint32_t max_n);
+
+#endif
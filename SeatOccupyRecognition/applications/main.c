@@ -13,10 +13,23 @@
 #include <unistd.h>
 #include <drv_lcd.h>
 #include <rtdef.h>
-#include <ctype.h>  // 用于isdigit函数
 
 #include "soft_wdt.h"
+#include "crash_record.h"
 #include "status_manager.h"
+#include "seat_db.h"
+#include "seat_trace.h"
+#include "seat_ingest.h"
+#include "mem_pool.h"
+#include "claim_policy.h"
+#include "ui_event.h"
+#include "ui_grid.h"
+#include "ui_single.h"
+#include "ui_pager.h"
+#include "ui_perf.h"
+#include "lcd_tile.h"
+#include "label_cache.h"
+#include "lcd_colors.h"
 #include "data_simulator.h"
 #include "wifi_module.h"
 
@@ -25,255 +38,37 @@
 #define DBG_LVL         DBG_LOG
 #include <rtdbg.h>
 
-// 座位状态字符串映射（通过头文件引入枚举）
-const char* seat_status_strings[] = {
-    "Available",
-    "Occupied",
-    "Claimed"
-};
-
-// 座位状态颜色映射
-#define WHITE           0xFFFF
-#define BLACK           0x0000
-#define GREEN           0x07E0
-#define RED             0xF800
-#define YELLOW          0xFFE0
-rt_uint16_t seat_status_colors[] = {
-    GREEN,      // 空闲-绿色
-    RED,        // 使用中-红色
-    YELLOW      // 占座中-黄色
-};
-
-// 数据库结构
-typedef struct {
-    uint8_t id;              // 座位ID
-    SeatStatus status;       // 座位状态
-    rt_tick_t update_tick;   // 最后更新的系统滴答数
-} SeatInfo;
-
-typedef struct {
-    SeatInfo seats[MAX_SEATS];  // 座位数组
-    rt_uint8_t count;           // 当前座位数量
-    rt_mutex_t lock;            // 互斥锁（注意：rt_mutex_t是指针类型）
-} SeatDatabase;
-
 // 全局变量
-SeatDatabase seat_db;         // 座位数据库
 SeatData g_seat_data = {0};   // 全局座位数据定义
-static soft_wdt_t *soft_wdt = RT_NULL;
+soft_wdt_t *g_soft_wdt = RT_NULL;   // 系统软件看门狗
 rt_uint8_t current_seat_id = 1;  // 当前显示的座位ID
 
-/* 数据库功能声明 */
-void db_init(void);
-rt_err_t db_update_seat_status(rt_uint8_t seat_id, SeatStatus status);
-SeatInfo* db_get_seat(rt_uint8_t seat_id);
-void db_display_all_seats(void);
-void update_database_from_udp(const char *seat_id_str, const char *status_str);
-
-/* 软件看门狗超时回调函数 */
-static void wdt_timeout_callback(void *arg)
-{
-    rt_kprintf("Software watchdog timeout! System will reset\n");
-    rt_hw_cpu_reset();
-}
-
-/* 将字符串状态转换为枚举值 */
-SeatStatus str_to_seat_status(const char *status_str)
-{
-    if (strcmp(status_str, "3") == 0 || strcmp(status_str, "4") == 0 || strcmp(status_str, "Available") == 0) {
-        return SEAT_AVAILABLE;
-    } else if (strcmp(status_str, "1") == 0 || strcmp(status_str, "Occupied") == 0) {
-        return SEAT_OCCUPIED;
-    } else if (strcmp(status_str, "2") == 0 || strcmp(status_str, "Claimed") == 0) {
-        return SEAT_CLAIMED;
-    }
-    return SEAT_AVAILABLE;
-}
-
-/* 显示单个座位信息到LCD（仅修改数据来源） */
-void show_seat_on_lcd(void)
-{
-    static rt_bool_t is_initialized = RT_FALSE;
-    static char last_seat_id[32] = {0};
-    static SeatStatus last_status = SEAT_AVAILABLE; // 记录上次状态
-
-    if (g_seat_data.new_data && g_seat_data.seat_id[0] != '\0') {
-        // 设置文本颜色为黑色，背景为白色
-        lcd_set_color(BLACK, WHITE);
-
-        // 首次显示或座位ID变化时显示标题、日期和座位ID
-        if (!is_initialized || strcmp(g_seat_data.seat_id, last_seat_id) != 0) {
-            // 显示标题和日期
-            lcd_show_string(10, 20, 24, "Seat Information");
-            char date_str[32];
-            rt_sprintf(date_str, "Date: 2025-07-05");
-            lcd_show_string(10, 50, 16, date_str);
-
-            // 绘制分隔线
-            lcd_draw_line(0, 75, 240, 75);
-
-            // 显示座位ID
-            char seat_info[32];
-            rt_sprintf(seat_info, "Seat ID: %s", g_seat_data.seat_id);
-            lcd_show_string(10, 90, 24, seat_info);
-
-            is_initialized = RT_TRUE;
-            strncpy(last_seat_id, g_seat_data.seat_id, sizeof(last_seat_id)-1);
-            last_seat_id[sizeof(last_seat_id)-1] = '\0';
-        }
-
-        // 从数据库获取座位状态（新增代码）
-        SeatInfo *seat = NULL;
-        if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) == RT_EOK) {
-            seat = db_get_seat(atoi(g_seat_data.seat_id));
-            rt_mutex_release(seat_db.lock);
-        }
-
-        // 状态分两行显示
-        SeatStatus status = SEAT_AVAILABLE;
-        if (seat) {
-            status = seat->status;
-        } else {
-            // 座位不存在时的处理（保持原有逻辑）
-            status = str_to_seat_status(g_seat_data.status);
-        }
-
-        /* 清除旧状态文字（用白色文字+白色背景覆盖） */
-        lcd_set_color(WHITE, WHITE);  // 白色文字+白色背景
-        lcd_show_string(10, 170, 32, seat_status_strings[last_status]);
-
-        /* 显示新状态文字（正确的颜色+白色背景） */
-        lcd_set_color(seat_status_colors[status], WHITE);  // 状态颜色+白色背景
-        lcd_show_string(10, 170, 32, seat_status_strings[status]);
-
-        /* 显示状态标题（黑色文字+白色背景） */
-        lcd_set_color(BLACK, WHITE);
-        lcd_show_string(10, 130, 32, "Status:");
-
-        // 保存当前状态
-        last_status = status;
-
-        g_seat_data.new_data = RT_FALSE;
-    }
-}
-
-void db_init(void) {
-    rt_memset(&seat_db, 0, sizeof(SeatDatabase));
-
-    // 使用rt_mutex_create创建互斥锁
-    seat_db.lock = rt_mutex_create("seat_lock", RT_IPC_FLAG_FIFO);
-    if (seat_db.lock == RT_NULL) {
-        LOG_E("Database mutex creation failed");
-        return;
-    }
-
-    LOG_I("Seat database initialized. Max seats: %d", MAX_SEATS);
-}
-
-rt_err_t db_update_seat_status(rt_uint8_t seat_id, SeatStatus status) {
-    SeatInfo *seat = NULL;
-
-    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
-        LOG_E("Failed to take mutex");
-        return -RT_ERROR;
-    }
-
-    // 在数据库中查找座位
-    for (int i = 0; i < seat_db.count; i++) {
-        if (seat_db.seats[i].id == seat_id) {
-            seat = &seat_db.seats[i];
-            break;
-        }
-    }
-
-    // 如果找不到座位，创建一个新的
-    if (seat == NULL) {
-        if (seat_db.count < MAX_SEATS) {
-            seat = &seat_db.seats[seat_db.count];
-            seat->id = seat_id;
-            seat_db.count++;
-        } else {
-            LOG_E("Database full, cannot add new seat!");
-            rt_mutex_release(seat_db.lock);
-            return -RT_ERROR;
-        }
-    }
-
-    // 更新座位信息
-    seat->status = status;
-    seat->update_tick = rt_tick_get();
-
-    LOG_I("Seat %d updated to %s", seat->id, seat_status_strings[seat->status]);
-
-    rt_mutex_release(seat_db.lock);
-    return RT_EOK;
-}
-
-SeatInfo* db_get_seat(rt_uint8_t seat_id) {
-    SeatInfo *seat = RT_NULL;
-
-    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
-        LOG_E("Failed to take mutex");
-        return RT_NULL;
-    }
-
-    for (int i = 0; i < seat_db.count; i++) {
-        if (seat_db.seats[i].id == seat_id) {
-            seat = &seat_db.seats[i];
-            break;
-        }
-    }
-
-    rt_mutex_release(seat_db.lock);
-    return seat;
-}
+/* UI显示模式：单座位详情 / 多座位网格 */
+typedef enum {
+    UI_MODE_SINGLE = 0,
+    UI_MODE_GRID,
+    UI_MODE_PAGED,
+} ui_mode_t;
 
-void db_display_all_seats(void) {
-    LOG_I("=== All Seats Status ===");
+static volatile ui_mode_t ui_mode = UI_MODE_SINGLE;
+static volatile rt_bool_t ui_mode_changed = RT_FALSE;
 
-    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
-        LOG_E("Failed to take mutex");
-        return;
-    }
-
-    for (int i = 0; i < seat_db.count; i++) {
-        SeatInfo *seat = &seat_db.seats[i];
-        LOG_I("Seat %d: %-10s Updated: %d ticks",
-              seat->id,
-              seat_status_strings[seat->status],
-              (int)seat->update_tick);
-    }
+/* 线程对象与栈静态分配，不占用堆 */
+static struct rt_thread ui_thread;
+ALIGN(RT_ALIGN_SIZE) static rt_uint8_t ui_thread_stack[2048];
 
-    rt_mutex_release(seat_db.lock);
-}
+/* UI线程心跳截止时间：事件等待最长UI_MAX_REFRESH_MS，留出整屏重绘余量 */
+#define UI_HEARTBEAT_MS     5000
 
-void update_database_from_udp(const char *seat_id_str, const char *status_str) {
-    // 跳过非数字字符（如'A'），只解析数字部分
-    const char *id_start = seat_id_str;
-    while (*id_start != '\0' && !isdigit(*id_start)) {
-        id_start++;
-    }
-
-    // 转换数字部分
-    rt_uint8_t seat_id = atoi(id_start);
-    SeatStatus status = str_to_seat_status(status_str);
-
-    // 参数有效性检查
-    if (seat_id == 0 || status > SEAT_CLAIMED) {
-        LOG_W("Invalid seat data: ID=%d, status=%d (raw ID=%s, raw status=%s)",
-              seat_id, status, seat_id_str, status_str);
-        return;
-    }
-
-    // 更新数据库
-    db_update_seat_status(seat_id, status);
-
-    // 更新全局数据用于显示（确保ID和状态正确）
-    strncpy(g_seat_data.seat_id, seat_id_str, sizeof(g_seat_data.seat_id) - 1);
-    strncpy(g_seat_data.status, status_str, sizeof(g_seat_data.status) - 1);
+/* 软件看门狗超时回调函数 */
+static void wdt_timeout_callback(void *arg)
+{
+    const soft_wdt_channel_t *ch = soft_wdt_expired(g_soft_wdt);
 
-    // 强制触发显示更新（确保UI线程刷新）
-    g_seat_data.new_data = RT_TRUE;
+    rt_kprintf("Software watchdog timeout (%s)! System will reset\n", ch ? ch->name : "feed");
+    /* 复位前把现场写入保留RAM，重启后用crash_info查看 */
+    crash_record_capture(CRASH_REASON_SOFT_WDT, ch ? ch->name : RT_NULL, ch ? ch->last_beat : 0);
+    rt_hw_cpu_reset();
 }
 
 static void ui_thread_entry(void *param) {
@@ -290,45 +85,117 @@ static void ui_thread_entry(void *param) {
     rt_kprintf("[UI] LCD init done\n");
 
     lcd_clear(WHITE);
+    rt_bool_t pending = RT_FALSE;
+    int wdt_ch = soft_wdt_register(g_soft_wdt, "ui", UI_HEARTBEAT_MS);
     while(1) {
-        if (g_connected) {
-            // 显示座位信息到LCD
-            show_seat_on_lcd();
+        /* 阻塞等待数据库或网络事件，超时后兜底刷新一次；分页渲染未完成时只让出1ms */
+        ui_event_wait(pending ? 1 : UI_MAX_REFRESH_MS);
+        pending = RT_FALSE;
+
+        /* 切换显示模式时清屏并整屏重绘 */
+        if (ui_mode_changed) {
+            ui_mode_changed = RT_FALSE;
+            lcd_clear(WHITE);
+            ui_single_invalidate();
+            ui_grid_invalidate();
+            ui_pager_invalidate();
+            g_seat_data.new_data = (g_seat_data.seat_id[0] != '\0');
+        }
 
-            if (soft_wdt) {
-                soft_wdt_feed(soft_wdt);
+        /* 有数据来源时才刷新：网络已连接，或模拟器正在注入 */
+        if (g_connected || data_simulator_running()) {
+            ui_perf_frame_begin();
+            if (ui_mode == UI_MODE_GRID) {
+                ui_grid_refresh();
+            } else if (ui_mode == UI_MODE_PAGED) {
+                pending = ui_pager_refresh();
+            } else {
+                // 显示座位信息到LCD
+                show_seat_on_lcd();
             }
-
-            rt_thread_mdelay(500);
+            ui_perf_frame_end();
         }
+
+        soft_wdt_heartbeat(g_soft_wdt, wdt_ch);
     }
 }
 
-/* 周期性喂狗线程 */
-static void feed_thread_entry(void *param) {
-    while (1) {
-        if (soft_wdt) {
-            soft_wdt_feed(soft_wdt);
-            rt_kprintf("[WDT] Feed software watchdog\n");
-        }
-        rt_thread_mdelay(2000);
+/* MSH命令：切换显示模式 ui_mode <single|grid|paged> [首个座位ID] */
+static void ui_mode_cmd(int argc, char **argv)
+{
+    if (argc < 2) {
+        rt_kprintf("Usage: ui_mode <single|grid|paged> [first_seat]\n");
+        rt_kprintf("Current mode: %s\n", ui_mode == UI_MODE_GRID ? "grid" :
+                                          ui_mode == UI_MODE_PAGED ? "paged" : "single");
+        return;
     }
+
+    if (strcmp(argv[1], "grid") == 0) {
+        if (argc > 2) {
+            ui_grid_set_origin(atoi(argv[2]));
+        }
+        ui_mode = UI_MODE_GRID;
+    } else if (strcmp(argv[1], "paged") == 0) {
+        ui_mode = UI_MODE_PAGED;
+    } else {
+        ui_mode = UI_MODE_SINGLE;
+    }
+    ui_mode_changed = RT_TRUE;
+    ui_event_post(UI_EVT_SEAT_SELECTED);
+}
+MSH_CMD_EXPORT_ALIAS(ui_mode_cmd, ui_mode, switch LCD view: ui_mode <single|grid|paged> [first_seat]);
+
+/* MSH命令：查看各线程心跳 */
+static void wdt_stat(int argc, char **argv)
+{
+    soft_wdt_dump(g_soft_wdt);
 }
+MSH_CMD_EXPORT(wdt_stat, show software watchdog heartbeat channels);
 
 int main(void) {
-    rt_thread_t tid = RT_NULL;
+    /* 最先检查保留RAM中的复位现场并累计启动次数 */
+    crash_record_init();
+
+    /* UI事件需在各生产者启动前就绪 */
+    ui_event_init();
+
+    /* LCD瓦片传输后端，启用DMA时CPU合成与像素传输并行 */
+#ifdef SEAT_LCD_TILE_USING_DMA
+    lcd_tile_init(&lcd_tile_dma_backend);
+#else
+    lcd_tile_init(&lcd_tile_sync_backend);
+#endif
+    label_cache_init();
+    if (ui_pager_init() != RT_EOK) {
+        rt_kprintf("Paged view labels not cached, drawing them from the font\n");
+    }
+    ui_perf_init();
 
     /* 初始化软件看门狗 */
-    soft_wdt = soft_wdt_init("soft_wdt", 5000, wdt_timeout_callback, RT_NULL);
-    if (!soft_wdt) {
+    g_soft_wdt = soft_wdt_init("soft_wdt", 5000, wdt_timeout_callback, RT_NULL);
+    if (!g_soft_wdt) {
         rt_kprintf("Software watchdog initialization failed!\n");
         return RT_ERROR;
     }
-    soft_wdt_start(soft_wdt);
+    soft_wdt_start(g_soft_wdt);
+
+    /* 独立看门狗兜底：线程停摆或时钟中断长时间被关闭时不再喂狗，由硬件复位 */
+    if (soft_wdt_attach_hw(g_soft_wdt, "wdt") != RT_EOK) {
+        rt_kprintf("Hardware watchdog unavailable, software supervision only\n");
+    }
 
     /* 初始化数据库 */
     db_init();
 
+    /* 入口流量追踪，默认关闭，用msh命令trace开启 */
+    seat_trace_init();
+
+    /* 接收线程与数据模拟器共用的入库路径 */
+    seat_ingest_init();
+
+    /* 启动占座超时策略 */
+    claim_policy_init();
+
     /* 添加初始数据 */
     db_update_seat_status(1, SEAT_AVAILABLE);
     db_update_seat_status(2, SEAT_OCCUPIED);
@@ -336,24 +203,32 @@ int main(void) {
     /* 初始化状态管理器 */
     status_init();
 
-    /* 创建周期性喂狗线程 */
-    tid = rt_thread_create("feed", feed_thread_entry,
-                          NULL, 1024, RT_THREAD_PRIORITY_MAX - 3, 10);
-    if(tid) rt_thread_startup(tid);
-
     /* 创建UI线程 */
-    tid = rt_thread_create("ui", ui_thread_entry,
-                          NULL, 2048, RT_THREAD_PRIORITY_MAX - 5, 10);
-    if(tid) rt_thread_startup(tid);
+    if (rt_thread_init(&ui_thread, "ui", ui_thread_entry, NULL,
+                       ui_thread_stack, sizeof(ui_thread_stack),
+                       RT_THREAD_PRIORITY_MAX - 5, 10) == RT_EOK) {
+        rt_thread_startup(&ui_thread);
+    }
 
+    /* 进程内模拟器，可随时用msh命令sim启动 */
+    data_simulator_init();
+
+#ifdef SEAT_USING_SIMULATOR
+    /* 台架模式：不启动WiFi，由模拟器按场景驱动入库与显示 */
+    data_simulator_start_scenario(SEAT_SIM_SCENARIO_SPEED);
+#else
     /* 初始化 WiFi 模块 */
     if (wifi_module_init() != RT_EOK) {
         rt_kprintf("WiFi模块初始化失败，系统退出\n");
         return -1;
     }
+#endif
 
     rt_kprintf("System startup completed, software watchdog enabled\n");
 
+    /* 启动完成后的内存映射报告 */
+    mem_pool_report();
+
     while (1) {
         rt_thread_mdelay(500);
     }
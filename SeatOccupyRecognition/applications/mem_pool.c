@@ -0,0 +1,118 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <finsh.h>
+
+#include "mem_pool.h"
+
+static mem_pool_t *pool_list = RT_NULL;
+
+static void pool_link(mem_pool_t *pool)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    pool->next = pool_list;
+    pool_list = pool;
+    rt_hw_interrupt_enable(level);
+}
+
+rt_err_t mem_pool_init(mem_pool_t *pool, const char *name, void *storage, rt_size_t storage_size,
+                       rt_size_t block_size)
+{
+    rt_err_t result;
+
+    rt_memset(pool, 0, sizeof(mem_pool_t));
+    result = rt_mp_init(&pool->mp, name, storage, storage_size, block_size);
+    if (result != RT_EOK) {
+        rt_kprintf("Memory pool %s init failed\n", name);
+        return result;
+    }
+
+    pool->name = name;
+    pool->is_mempool = RT_TRUE;
+    pool->block_size = block_size;
+    pool->block_count = pool->mp.block_total_count;
+    pool_link(pool);
+
+    return RT_EOK;
+}
+
+void mem_pool_register(mem_pool_t *pool, const char *name, rt_size_t block_size, rt_size_t block_count)
+{
+    rt_memset(pool, 0, sizeof(mem_pool_t));
+    pool->name = name;
+    pool->is_mempool = RT_FALSE;
+    pool->block_size = block_size;
+    pool->block_count = block_count;
+    pool_link(pool);
+}
+
+void *mem_pool_alloc(mem_pool_t *pool, rt_int32_t timeout)
+{
+    void *block = rt_mp_alloc(&pool->mp, timeout);
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (block) {
+        pool->used++;
+        if (pool->used > pool->peak) {
+            pool->peak = pool->used;
+        }
+    } else {
+        pool->fail_count++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return block;
+}
+
+void mem_pool_free(mem_pool_t *pool, void *block)
+{
+    rt_base_t level;
+
+    if (block == RT_NULL) {
+        return;
+    }
+
+    rt_mp_free(block);
+
+    level = rt_hw_interrupt_disable();
+    pool->used--;
+    rt_hw_interrupt_enable(level);
+}
+
+void mem_pool_note_usage(mem_pool_t *pool, rt_size_t used)
+{
+    pool->used = used;
+    if (used > pool->peak) {
+        pool->peak = used;
+    }
+}
+
+void mem_pool_report(void)
+{
+    rt_size_t total = 0;
+
+    rt_kprintf("pool         block  count   bytes  used  peak  fail\n");
+    rt_kprintf("------------ ----- ------ ------- ----- ----- -----\n");
+    for (mem_pool_t *pool = pool_list; pool != RT_NULL; pool = pool->next) {
+        rt_size_t bytes = pool->block_size * pool->block_count;
+        total += bytes;
+        rt_kprintf("%-12s %5d %6d %7d %5d %5d %5d\n",
+                   pool->name, pool->block_size, pool->block_count, bytes,
+                   pool->used, pool->peak, pool->fail_count);
+    }
+    rt_kprintf("static pools total: %d bytes\n", total);
+
+#ifdef RT_USING_HEAP
+    {
+        rt_size_t heap_total = 0, heap_used = 0, heap_max = 0;
+        rt_memory_info(&heap_total, &heap_used, &heap_max);
+        rt_kprintf("heap: total %d, used %d, max used %d\n", heap_total, heap_used, heap_max);
+    }
+#endif
+}
+
+static void mem_map(int argc, char **argv)
+{
+    mem_pool_report();
+}
+MSH_CMD_EXPORT(mem_map, show static memory pools and high-water usage);
@@ -0,0 +1,36 @@
+#ifndef __MEM_POOL_H__
+#define __MEM_POOL_H__
+
+#include <rtthread.h>
+
+/* 静态内存池：启动后热路径不再使用堆，所有池在内存映射报告中登记 */
+typedef struct mem_pool {
+    const char *name;
+    struct rt_mempool mp;       // 块分配池（静态数组区域为RT_NULL）
+    rt_bool_t is_mempool;
+    rt_size_t block_size;       // 单块大小（字节）
+    rt_size_t block_count;      // 块数量
+    rt_size_t used;             // 当前使用块数
+    rt_size_t peak;             // 使用高水位
+    rt_uint32_t fail_count;     // 分配失败次数
+    struct mem_pool *next;
+} mem_pool_t;
+
+/* 定义静态存储区，count个大小为block_size的块（含rt_mempool块头） */
+#define MEM_POOL_STORAGE(name, block_size, count) \
+    ALIGN(RT_ALIGN_SIZE) static rt_uint8_t name[(RT_ALIGN(block_size, RT_ALIGN_SIZE) + sizeof(rt_uint8_t *)) * (count)]
+
+/* 以静态存储初始化块分配池并登记 */
+rt_err_t mem_pool_init(mem_pool_t *pool, const char *name, void *storage, rt_size_t storage_size,
+                       rt_size_t block_size);
+/* 登记静态数组区域（非块分配），使用量由所有者通过mem_pool_note_usage上报 */
+void mem_pool_register(mem_pool_t *pool, const char *name, rt_size_t block_size, rt_size_t block_count);
+
+void *mem_pool_alloc(mem_pool_t *pool, rt_int32_t timeout);
+void mem_pool_free(mem_pool_t *pool, void *block);
+void mem_pool_note_usage(mem_pool_t *pool, rt_size_t used);
+
+/* 打印内存映射：各池大小与高水位 */
+void mem_pool_report(void);
+
+#endif
@@ -0,0 +1,106 @@
+#include <rtthread.h>
+#include "seat_bitmap.h"
+
+/* GCC/armclang下CTZ编译为RBIT+CLZ两条指令，其余编译器退回__rt_ffs */
+#if defined(__GNUC__) || defined(__clang__)
+#define BITMAP_CTZ(w)       ((rt_uint32_t)__builtin_ctz(w))
+#define BITMAP_POPCOUNT(w)  ((rt_uint32_t)__builtin_popcount(w))
+#else
+#define BITMAP_CTZ(w)       ((rt_uint32_t)(__rt_ffs((int)(w)) - 1))
+static rt_uint32_t BITMAP_POPCOUNT(rt_uint32_t w)
+{
+    w = w - ((w >> 1) & 0x55555555UL);
+    w = (w & 0x33333333UL) + ((w >> 2) & 0x33333333UL);
+    return (((w + (w >> 4)) & 0x0F0F0F0FUL) * 0x01010101UL) >> 24;
+}
+#endif
+
+/* 第idx个字在[begin, end)内的有效位掩码 */
+static rt_uint32_t range_mask(rt_uint32_t idx, rt_uint32_t begin, rt_uint32_t end)
+{
+    rt_uint32_t mask = 0xFFFFFFFFUL;
+
+    if (idx == begin / SEAT_BITMAP_WORD_BITS) {
+        mask &= 0xFFFFFFFFUL << (begin % SEAT_BITMAP_WORD_BITS);
+    }
+    if (idx == (end - 1) / SEAT_BITMAP_WORD_BITS && (end % SEAT_BITMAP_WORD_BITS) != 0) {
+        mask &= (1UL << (end % SEAT_BITMAP_WORD_BITS)) - 1;
+    }
+    return mask;
+}
+
+rt_uint32_t seat_bitmap_find_first_n(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end,
+                                     rt_uint16_t *out, rt_uint32_t max_n)
+{
+    rt_uint32_t found = 0;
+    rt_uint32_t idx, last;
+
+    if (begin >= end || max_n == 0) {
+        return 0;
+    }
+
+    last = (end - 1) / SEAT_BITMAP_WORD_BITS;
+    for (idx = begin / SEAT_BITMAP_WORD_BITS; idx <= last && found < max_n; idx++) {
+        rt_uint32_t word = map[idx] & range_mask(idx, begin, end);
+
+        while (word && found < max_n) {
+            out[found++] = (rt_uint16_t)(idx * SEAT_BITMAP_WORD_BITS + BITMAP_CTZ(word));
+            word &= word - 1;   // 清除最低置位bit
+        }
+    }
+
+    return found;
+}
+
+rt_uint32_t seat_bitmap_count_range(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end)
+{
+    rt_uint32_t count = 0;
+    rt_uint32_t idx, last;
+
+    if (begin >= end) {
+        return 0;
+    }
+
+    last = (end - 1) / SEAT_BITMAP_WORD_BITS;
+    for (idx = begin / SEAT_BITMAP_WORD_BITS; idx <= last; idx++) {
+        count += BITMAP_POPCOUNT(map[idx] & range_mask(idx, begin, end));
+    }
+
+    return count;
+}
+
+static rt_int32_t find_first_set(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end)
+{
+    rt_uint32_t idx, last;
+
+    if (begin >= end) {
+        return -1;
+    }
+
+    last = (end - 1) / SEAT_BITMAP_WORD_BITS;
+    for (idx = begin / SEAT_BITMAP_WORD_BITS; idx <= last; idx++) {
+        rt_uint32_t word = map[idx] & range_mask(idx, begin, end);
+        if (word) {
+            return (rt_int32_t)(idx * SEAT_BITMAP_WORD_BITS + BITMAP_CTZ(word));
+        }
+    }
+
+    return -1;
+}
+
+rt_int32_t seat_bitmap_find_next_wrap(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end,
+                                      rt_uint32_t from)
+{
+    rt_int32_t bit;
+
+    if (from < begin || from >= end) {
+        from = begin;
+    }
+
+    bit = find_first_set(map, from, end);
+    if (bit < 0) {
+        bit = find_first_set(map, begin, from);
+    }
+
+    return bit;
+}
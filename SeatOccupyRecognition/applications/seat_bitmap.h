@@ -0,0 +1,36 @@
+#ifndef __SEAT_BITMAP_H__
+#define __SEAT_BITMAP_H__
+
+#include <rtthread.h>
+
+/* 座位位图：每个bit对应一个座位ID，按32位字扫描 */
+#define SEAT_BITMAP_WORD_BITS    32
+#define SEAT_BITMAP_WORDS(nbits) (((nbits) + SEAT_BITMAP_WORD_BITS - 1) / SEAT_BITMAP_WORD_BITS)
+
+rt_inline void seat_bitmap_set(rt_uint32_t *map, rt_uint32_t bit)
+{
+    map[bit / SEAT_BITMAP_WORD_BITS] |= (1UL << (bit % SEAT_BITMAP_WORD_BITS));
+}
+
+rt_inline void seat_bitmap_clear(rt_uint32_t *map, rt_uint32_t bit)
+{
+    map[bit / SEAT_BITMAP_WORD_BITS] &= ~(1UL << (bit % SEAT_BITMAP_WORD_BITS));
+}
+
+rt_inline rt_bool_t seat_bitmap_test(const rt_uint32_t *map, rt_uint32_t bit)
+{
+    return (map[bit / SEAT_BITMAP_WORD_BITS] >> (bit % SEAT_BITMAP_WORD_BITS)) & 1UL;
+}
+
+/* 在[begin, end)内按升序取出最多max_n个置位bit，返回实际个数 */
+rt_uint32_t seat_bitmap_find_first_n(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end,
+                                     rt_uint16_t *out, rt_uint32_t max_n);
+
+/* 统计[begin, end)内置位bit数量 */
+rt_uint32_t seat_bitmap_count_range(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end);
+
+/* 从from开始在[begin, end)内查找下一个置位bit，到末尾后回绕，找不到返回-1 */
+rt_int32_t seat_bitmap_find_next_wrap(const rt_uint32_t *map, rt_uint32_t begin, rt_uint32_t end,
+                                      rt_uint32_t from);
+
+#endif
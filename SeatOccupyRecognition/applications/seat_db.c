@@ -0,0 +1,397 @@
+#include <rtthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <finsh.h>
+
+#include "seat_db.h"
+#include "claim_policy.h"
+#include "ui_event.h"
+
+#define DBG_TAG "seat_db"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+// 座位状态字符串映射（通过头文件引入枚举）
+const char* seat_status_strings[] = {
+    "Available",
+    "Occupied",
+    "Claimed"
+};
+
+SeatDatabase seat_db;         // 座位数据库
+mem_pool_t seat_ingest_pool;
+
+static struct rt_mutex seat_db_mutex;
+static mem_pool_t seat_store_pool;
+static mem_pool_t seat_telemetry_pool;
+MEM_POOL_STORAGE(seat_ingest_storage, sizeof(seat_record_t) * SEAT_INGEST_FRAME_MAX, SEAT_INGEST_POOL_SIZE);
+
+/* 将字符串状态转换为枚举值 */
+SeatStatus str_to_seat_status(const char *status_str)
+{
+    if (strcmp(status_str, "3") == 0 || strcmp(status_str, "4") == 0 || strcmp(status_str, "Available") == 0) {
+        return SEAT_AVAILABLE;
+    } else if (strcmp(status_str, "1") == 0 || strcmp(status_str, "Occupied") == 0) {
+        return SEAT_OCCUPIED;
+    } else if (strcmp(status_str, "2") == 0 || strcmp(status_str, "Claimed") == 0) {
+        return SEAT_CLAIMED;
+    }
+    return SEAT_AVAILABLE;
+}
+
+void db_init(void) {
+    rt_memset(&seat_db, 0, sizeof(SeatDatabase));
+
+    // 静态互斥锁，不占用堆
+    if (rt_mutex_init(&seat_db_mutex, "seat_lock", RT_IPC_FLAG_FIFO) != RT_EOK) {
+        LOG_E("Database mutex init failed");
+        return;
+    }
+    seat_db.lock = &seat_db_mutex;
+
+    mem_pool_register(&seat_store_pool, "seat_store", sizeof(SeatInfo), SEAT_DB_MAX_SEATS);
+    mem_pool_register(&seat_telemetry_pool, "telemetry", sizeof(SeatTransition), SEAT_TELEMETRY_DEPTH);
+    mem_pool_init(&seat_ingest_pool, "ingest", seat_ingest_storage, sizeof(seat_ingest_storage),
+                  sizeof(seat_record_t) * SEAT_INGEST_FRAME_MAX);
+
+    LOG_I("Seat database initialized. Max seats: %d", SEAT_DB_MAX_SEATS);
+}
+
+/* 记录一次状态变迁（调用者已持有锁） */
+static void record_transition(rt_uint16_t seat_id, rt_uint8_t old_status, rt_uint8_t new_status)
+{
+    SeatTransition *t = &seat_db.history[seat_db.history_total % SEAT_TELEMETRY_DEPTH];
+
+    t->seat_id = seat_id;
+    t->old_status = old_status;
+    t->new_status = new_status;
+    t->tick = rt_tick_get();
+    seat_db.history_total++;
+
+    mem_pool_note_usage(&seat_telemetry_pool, seat_db.history_total < SEAT_TELEMETRY_DEPTH ?
+                        seat_db.history_total : SEAT_TELEMETRY_DEPTH);
+}
+
+/* 更新单个座位（调用者已持有锁且已校验参数），返回RT_NULL表示数据库已满 */
+static SeatInfo *db_apply_locked(rt_uint16_t seat_id, SeatStatus status, rt_tick_t now,
+                                 rt_bool_t *changed) {
+    SeatInfo *seat = NULL;
+
+    // 在数据库中查找座位
+    for (int i = 0; i < seat_db.count; i++) {
+        if (seat_db.seats[i].id == seat_id) {
+            seat = &seat_db.seats[i];
+            break;
+        }
+    }
+
+    // 如果找不到座位，创建一个新的
+    if (seat == NULL) {
+        if (seat_db.count < SEAT_DB_MAX_SEATS) {
+            seat = &seat_db.seats[seat_db.count];
+            seat->id = seat_id;
+            seat->status = (SeatStatus)SEAT_STATUS_NUM;
+            seat_db.count++;
+            mem_pool_note_usage(&seat_store_pool, seat_db.count);
+        } else {
+            return RT_NULL;
+        }
+    } else {
+        seat_bitmap_clear(seat_db.status_map[seat->status], seat_id);
+    }
+
+    *changed = (seat->status != status);
+    if (*changed) {
+        record_transition(seat_id, seat->status, status);
+        claim_policy_on_transition(seat_id, seat->status, status);
+        seat->flags = 0;
+        seat_db.zone_generation[SEAT_ZONE_OF(seat_id)]++;
+        seat_db.generation++;
+        seat_bitmap_set(seat_db.dirty_map, seat_id);
+    } else {
+        seat_db.suppressed_writes++;
+    }
+
+    // 更新座位信息
+    seat->status = status;
+    seat->update_tick = now;
+    seat_bitmap_set(seat_db.status_map[status], seat_id);
+
+    return seat;
+}
+
+rt_err_t db_update_seat_status(rt_uint16_t seat_id, SeatStatus status) {
+    SeatInfo *seat;
+    rt_bool_t changed;
+
+    if (seat_id >= SEAT_ID_LIMIT || status >= SEAT_STATUS_NUM) {
+        LOG_E("Seat %d out of range", seat_id);
+        return -RT_ERROR;
+    }
+
+    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
+        LOG_E("Failed to take mutex");
+        return -RT_ERROR;
+    }
+
+    seat = db_apply_locked(seat_id, status, rt_tick_get(), &changed);
+    if (seat == RT_NULL) {
+        LOG_E("Database full, cannot add new seat!");
+        rt_mutex_release(seat_db.lock);
+        return -RT_ERROR;
+    }
+
+    LOG_I("Seat %d updated to %s", seat->id, seat_status_strings[seat->status]);
+
+    rt_mutex_release(seat_db.lock);
+
+    if (changed) {
+        ui_event_post(UI_EVT_SEAT_CHANGED);
+    }
+    return RT_EOK;
+}
+
+SeatInfo* db_get_seat(rt_uint16_t seat_id) {
+    SeatInfo *seat = RT_NULL;
+
+    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
+        LOG_E("Failed to take mutex");
+        return RT_NULL;
+    }
+
+    for (int i = 0; i < seat_db.count; i++) {
+        if (seat_db.seats[i].id == seat_id) {
+            seat = &seat_db.seats[i];
+            break;
+        }
+    }
+
+    rt_mutex_release(seat_db.lock);
+    return seat;
+}
+
+void db_batch_begin(seat_batch_t *batch, seat_record_t *storage, rt_uint16_t capacity) {
+    batch->records = storage;
+    batch->capacity = capacity;
+    batch->count = 0;
+    batch->rejected = 0;
+    batch->changed = 0;
+    batch->committed = 0;
+}
+
+/* 暂存一条记录，参数校验在加锁前完成 */
+rt_err_t db_batch_apply(seat_batch_t *batch, rt_uint16_t seat_id, SeatStatus status) {
+    if (seat_id >= SEAT_ID_LIMIT || status >= SEAT_STATUS_NUM || batch->count >= batch->capacity) {
+        batch->rejected++;
+        return -RT_ERROR;
+    }
+
+    batch->records[batch->count].seat_id = seat_id;
+    batch->records[batch->count].status = status;
+    batch->count++;
+    return RT_EOK;
+}
+
+/* 一次加锁应用全部记录，结束后只输出一行汇总日志 */
+rt_err_t db_batch_commit(seat_batch_t *batch) {
+    rt_tick_t now = rt_tick_get();
+    rt_uint16_t full = 0;
+
+    if (batch->count == 0) {
+        return RT_EOK;
+    }
+
+    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
+        LOG_E("Failed to take mutex");
+        return -RT_ERROR;
+    }
+
+    for (rt_uint16_t i = 0; i < batch->count; i++) {
+        seat_record_t *rec = &batch->records[i];
+        rt_bool_t changed;
+
+        rec->tick = now;
+        if (db_apply_locked(rec->seat_id, (SeatStatus)rec->status, now, &changed) == RT_NULL) {
+            full++;
+            continue;
+        }
+        batch->committed++;
+        if (changed) {
+            batch->changed++;
+        }
+    }
+
+    rt_mutex_release(seat_db.lock);
+
+    if (batch->changed) {
+        ui_event_post(UI_EVT_SEAT_CHANGED);
+    }
+
+    batch->rejected += full;
+    LOG_I("Batch of %d seats committed: %d changed, %d rejected%s",
+          batch->count, batch->changed, batch->rejected, full ? " (database full)" : "");
+
+    return full ? -RT_EFULL : RT_EOK;
+}
+
+rt_err_t db_set_seat_flags(rt_uint16_t seat_id, rt_uint8_t flags) {
+    SeatInfo *seat;
+    rt_err_t result = -RT_ERROR;
+
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    seat = db_get_seat(seat_id);
+    if (seat) {
+        if ((seat->flags & flags) != flags) {
+            seat->flags |= flags;
+            seat_db.zone_generation[SEAT_ZONE_OF(seat_id)]++;
+            seat_db.generation++;
+            seat_bitmap_set(seat_db.dirty_map, seat_id);
+            ui_event_post(UI_EVT_SEAT_CHANGED);
+        }
+        result = RT_EOK;
+    }
+    rt_mutex_release(seat_db.lock);
+
+    return result;
+}
+
+void db_take_dirty(rt_uint32_t *out) {
+    for (rt_uint32_t i = 0; i < SEAT_BITMAP_WORDS(SEAT_ID_LIMIT); i++) {
+        out[i] |= seat_db.dirty_map[i];
+        seat_db.dirty_map[i] = 0;
+    }
+}
+
+void db_display_all_seats(void) {
+    LOG_I("=== All Seats Status ===");
+
+    if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) != RT_EOK) {
+        LOG_E("Failed to take mutex");
+        return;
+    }
+
+    for (int i = 0; i < seat_db.count; i++) {
+        SeatInfo *seat = &seat_db.seats[i];
+        LOG_I("Seat %d: %-10s Updated: %d ticks%s",
+              seat->id,
+              seat_status_strings[seat->status],
+              (int)seat->update_tick,
+              (seat->flags & SEAT_FLAG_CLAIM_EXPIRED) ? " (claim expired)" : "");
+    }
+
+    rt_mutex_release(seat_db.lock);
+}
+
+/* MSH命令：显示最近的座位状态变迁 */
+static void seat_history(int argc, char **argv)
+{
+    rt_uint32_t total, n;
+
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    total = seat_db.history_total;
+    n = total < SEAT_TELEMETRY_DEPTH ? total : SEAT_TELEMETRY_DEPTH;
+    rt_kprintf("Last %d of %d transitions:\n", n, total);
+    for (rt_uint32_t i = total - n; i < total; i++) {
+        SeatTransition *t = &seat_db.history[i % SEAT_TELEMETRY_DEPTH];
+        rt_kprintf("  [%8d] Seat %d: %s -> %s\n", (int)t->tick, t->seat_id,
+                   t->old_status < SEAT_STATUS_NUM ? seat_status_strings[t->old_status] : "New",
+                   seat_status_strings[t->new_status]);
+    }
+    rt_mutex_release(seat_db.lock);
+}
+MSH_CMD_EXPORT(seat_history, show recent seat status transitions);
+
+/* MSH命令：显示数据库代数与被抑制的重复写入 */
+static void seat_gen(int argc, char **argv)
+{
+    rt_kprintf("Generation        : %d\n", db_generation());
+    rt_kprintf("Suppressed writes : %d\n", seat_db.suppressed_writes);
+    for (rt_uint16_t zone = 0; zone < SEAT_ZONE_COUNT; zone++) {
+        if (seat_db.zone_generation[zone]) {
+            rt_kprintf("  Zone %d [%d, %d): %d\n", zone, zone * SEAT_ZONE_SIZE,
+                       (zone + 1) * SEAT_ZONE_SIZE, seat_db.zone_generation[zone]);
+        }
+    }
+}
+MSH_CMD_EXPORT(seat_gen, show seat database generations);
+
+/* 区间裁剪到位图范围内 */
+static rt_bool_t clamp_range(rt_uint16_t *begin, rt_uint16_t *end)
+{
+    if (*end > SEAT_ID_LIMIT) {
+        *end = SEAT_ID_LIMIT;
+    }
+    return *begin < *end;
+}
+
+rt_uint32_t db_find_available(rt_uint16_t begin, rt_uint16_t end, rt_uint16_t *ids, rt_uint32_t max_n) {
+    rt_uint32_t found;
+
+    if (!clamp_range(&begin, &end)) {
+        return 0;
+    }
+
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    found = seat_bitmap_find_first_n(seat_db.status_map[SEAT_AVAILABLE], begin, end, ids, max_n);
+    rt_mutex_release(seat_db.lock);
+
+    return found;
+}
+
+rt_uint32_t db_count_available(rt_uint16_t begin, rt_uint16_t end) {
+    rt_uint32_t count;
+
+    if (!clamp_range(&begin, &end)) {
+        return 0;
+    }
+
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    count = seat_bitmap_count_range(seat_db.status_map[SEAT_AVAILABLE], begin, end);
+    rt_mutex_release(seat_db.lock);
+
+    return count;
+}
+
+/* 轮询推荐：从上次推荐位置之后继续查找，避免所有终端都推荐同一座位 */
+rt_int32_t db_suggest_seat(rt_uint16_t begin, rt_uint16_t end) {
+    rt_int32_t seat_id;
+
+    if (!clamp_range(&begin, &end)) {
+        return -1;
+    }
+
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    seat_id = seat_bitmap_find_next_wrap(seat_db.status_map[SEAT_AVAILABLE], begin, end,
+                                         seat_db.rr_cursor);
+    if (seat_id >= 0) {
+        seat_db.rr_cursor = (rt_uint16_t)(seat_id + 1);
+    }
+    rt_mutex_release(seat_db.lock);
+
+    return seat_id;
+}
+
+/* MSH命令：seat_free [begin end [n]] */
+static void seat_free(int argc, char **argv)
+{
+    rt_uint16_t ids[8];
+    rt_uint16_t begin = 0, end = SEAT_ID_LIMIT;
+    rt_uint32_t max_n = 8, found;
+
+    if (argc >= 3) {
+        begin = atoi(argv[1]);
+        end = atoi(argv[2]);
+    }
+    if (argc >= 4) {
+        max_n = atoi(argv[3]);
+        if (max_n > 8) max_n = 8;
+    }
+
+    found = db_find_available(begin, end, ids, max_n);
+    rt_kprintf("Available in [%d, %d): %d seats\n", begin, end, db_count_available(begin, end));
+    for (rt_uint32_t i = 0; i < found; i++) {
+        rt_kprintf("  Seat %d\n", ids[i]);
+    }
+    rt_kprintf("Suggested: %d\n", db_suggest_seat(begin, end));
+}
+MSH_CMD_EXPORT(seat_free, list free seats: seat_free [begin end [n]]);
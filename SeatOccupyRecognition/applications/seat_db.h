@@ -0,0 +1,132 @@
+#ifndef __SEAT_DB_H__
+#define __SEAT_DB_H__
+
+#include <rtthread.h>
+#include "status_manager.h"
+#include "seat_bitmap.h"
+#include "mem_pool.h"
+
+/* 座位ID取值范围[0, SEAT_ID_LIMIT)，位图按此大小分配 */
+#ifndef SEAT_ID_LIMIT
+#define SEAT_ID_LIMIT       256
+#endif
+
+#ifndef SEAT_DB_MAX_SEATS
+#define SEAT_DB_MAX_SEATS   64
+#endif
+
+/* 单帧最多包含的座位记录数 */
+#ifndef SEAT_INGEST_FRAME_MAX
+#define SEAT_INGEST_FRAME_MAX   48
+#endif
+
+/* 入库帧缓冲块数，每块容纳一帧的SEAT_INGEST_FRAME_MAX条记录 */
+#ifndef SEAT_INGEST_POOL_SIZE
+#define SEAT_INGEST_POOL_SIZE   2
+#endif
+
+#ifndef SEAT_TELEMETRY_DEPTH
+#define SEAT_TELEMETRY_DEPTH    32
+#endif
+
+/* 分区大小：座位ID按此划分为连续分区，分区代数独立计数 */
+#ifndef SEAT_ZONE_SIZE
+#define SEAT_ZONE_SIZE      32
+#endif
+
+#define SEAT_ZONE_COUNT     ((SEAT_ID_LIMIT + SEAT_ZONE_SIZE - 1) / SEAT_ZONE_SIZE)
+#define SEAT_ZONE_OF(id)    ((id) / SEAT_ZONE_SIZE)
+
+#define SEAT_STATUS_NUM     (SEAT_CLAIMED + 1)
+
+/* 座位标志位，状态变迁时清除 */
+#define SEAT_FLAG_CLAIM_EXPIRED  0x01   // 占座已超时
+
+// 数据库结构
+typedef struct {
+    rt_uint16_t id;          // 座位ID
+    SeatStatus status;       // 座位状态
+    rt_uint8_t flags;        // SEAT_FLAG_*
+    rt_tick_t update_tick;   // 最后更新的系统滴答数
+} SeatInfo;
+
+/* 入库记录：解码后的一次座位上报 */
+typedef struct {
+    rt_uint16_t seat_id;
+    rt_uint8_t status;       // SeatStatus
+    rt_uint8_t source;       // 数据来源
+    rt_tick_t tick;          // 接收时刻
+} seat_record_t;
+
+/* 批量事务：先暂存并校验，提交时一次加锁全部应用 */
+typedef struct {
+    seat_record_t *records;  // 调用方提供的暂存区
+    rt_uint16_t capacity;
+    rt_uint16_t count;       // 已暂存的有效记录数
+    rt_uint16_t rejected;    // 校验失败的记录数
+    rt_uint16_t changed;     // 提交后实际发生状态变化的记录数
+    rt_uint16_t committed;   // 提交后写入数据库的记录数，库满的不计
+} seat_batch_t;
+
+/* 状态变迁遥测，环形保存最近SEAT_TELEMETRY_DEPTH条 */
+typedef struct {
+    rt_uint16_t seat_id;
+    rt_uint8_t old_status;   // 新建座位时为SEAT_STATUS_NUM
+    rt_uint8_t new_status;
+    rt_tick_t tick;
+} SeatTransition;
+
+typedef struct {
+    SeatInfo seats[SEAT_DB_MAX_SEATS];  // 座位数组
+    rt_uint16_t count;          // 当前座位数量
+    rt_mutex_t lock;            // 互斥锁（注意：rt_mutex_t是指针类型）
+    /* 按状态划分的占用位图，由写入方维护，查询时按字扫描 */
+    rt_uint32_t status_map[SEAT_STATUS_NUM][SEAT_BITMAP_WORDS(SEAT_ID_LIMIT)];
+    rt_uint16_t rr_cursor;      // 轮询推荐游标
+    SeatTransition history[SEAT_TELEMETRY_DEPTH];
+    rt_uint32_t history_total;  // 累计变迁次数
+    /* 代数：仅在状态实际变化时递增，读取方比较代数即可跳过未变化的数据 */
+    volatile rt_uint32_t generation;
+    volatile rt_uint32_t zone_generation[SEAT_ZONE_COUNT];
+    rt_uint32_t suppressed_writes;  // 同状态重复写入次数
+    /* 显示脏位：写入方在状态变化时置位，显示方取走后清零 */
+    rt_uint32_t dirty_map[SEAT_BITMAP_WORDS(SEAT_ID_LIMIT)];
+} SeatDatabase;
+
+extern SeatDatabase seat_db;
+extern mem_pool_t seat_ingest_pool;     // 入库帧缓冲池，每块SEAT_INGEST_FRAME_MAX条seat_record_t
+extern const char* seat_status_strings[];
+
+SeatStatus str_to_seat_status(const char *status_str);
+
+/* 数据库功能声明 */
+void db_init(void);
+rt_err_t db_update_seat_status(rt_uint16_t seat_id, SeatStatus status);
+SeatInfo* db_get_seat(rt_uint16_t seat_id);
+rt_err_t db_set_seat_flags(rt_uint16_t seat_id, rt_uint8_t flags);
+/* 取走显示脏位（按位或入out）并清零，调用者须持有seat_db.lock */
+void db_take_dirty(rt_uint32_t *out);
+
+/* 批量更新 */
+void db_batch_begin(seat_batch_t *batch, seat_record_t *storage, rt_uint16_t capacity);
+rt_err_t db_batch_apply(seat_batch_t *batch, rt_uint16_t seat_id, SeatStatus status);
+rt_err_t db_batch_commit(seat_batch_t *batch);
+void db_display_all_seats(void);
+
+/* 代数读取，32位读为原子操作，无需加锁 */
+rt_inline rt_uint32_t db_generation(void)
+{
+    return seat_db.generation;
+}
+
+rt_inline rt_uint32_t db_zone_generation(rt_uint16_t zone)
+{
+    return zone < SEAT_ZONE_COUNT ? seat_db.zone_generation[zone] : 0;
+}
+
+/* 空闲座位查询，区间均为[begin, end) */
+rt_uint32_t db_find_available(rt_uint16_t begin, rt_uint16_t end, rt_uint16_t *ids, rt_uint32_t max_n);
+rt_uint32_t db_count_available(rt_uint16_t begin, rt_uint16_t end);
+rt_int32_t db_suggest_seat(rt_uint16_t begin, rt_uint16_t end);
+
+#endif
@@ -0,0 +1,266 @@
+#include <rtthread.h>
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "seat_ingest.h"
+#include "seat_db.h"
+#include "seat_trace.h"
+#include "ui_event.h"
+#include "wifi_module.h"
+
+#define DBG_TAG "ingest"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+/* 序号倒退超过此值视为发送方重启，而不是乱序 */
+#define INGEST_SEQ_RESTART_GAP  1024
+
+/* 接收线程与模拟线程都会入库：解析、统计与来源表由ingest_lock串行化，
+ * msh读取时不加锁，允许看到中间状态 */
+static struct rt_mutex ingest_lock;
+static seat_ingest_stats_t ingest_stats;
+static seat_ingest_source_t ingest_sources[SEAT_INGEST_SOURCES];
+
+/* 跳过非数字字符（如'A'），只解析数字部分 */
+static rt_uint16_t parse_seat_id(const char *seat_id_str) {
+    const char *id_start = seat_id_str;
+    while (*id_start != '\0' && !isdigit(*id_start)) {
+        id_start++;
+    }
+    return atoi(id_start);
+}
+
+void update_database_from_udp(const char *seat_id_str, const char *status_str) {
+    // 转换数字部分
+    rt_uint16_t seat_id = parse_seat_id(seat_id_str);
+    SeatStatus status = str_to_seat_status(status_str);
+
+    // 参数有效性检查
+    if (seat_id == 0 || seat_id >= SEAT_ID_LIMIT || status > SEAT_CLAIMED) {
+        LOG_W("Invalid seat data: ID=%d, status=%d (raw ID=%s, raw status=%s)",
+              seat_id, status, seat_id_str, status_str);
+        ingest_stats.rejected++;
+        return;
+    }
+
+    // 更新数据库，库满时记为拒收
+    if (db_update_seat_status(seat_id, status) != RT_EOK) {
+        ingest_stats.rejected++;
+        return;
+    }
+    ingest_stats.records++;
+
+    // 更新全局数据用于显示（确保ID和状态正确）
+    strncpy(g_seat_data.seat_id, seat_id_str, sizeof(g_seat_data.seat_id) - 1);
+    strncpy(g_seat_data.status, status_str, sizeof(g_seat_data.status) - 1);
+
+    // 强制触发显示更新（确保UI线程刷新）
+    g_seat_data.new_data = RT_TRUE;
+    ui_event_post(UI_EVT_SEAT_SELECTED);
+}
+
+/* 批量帧格式 "A01:1;A02:2;..."，整帧在一次加锁内提交 */
+void update_database_from_frame(char *frame) {
+    seat_record_t *records;
+    seat_batch_t batch;
+    char *save = RT_NULL;
+    char *last_id = RT_NULL, *last_status = RT_NULL;
+
+    /* 暂存区取自入库帧缓冲池，不占用接收线程的栈 */
+    records = mem_pool_alloc(&seat_ingest_pool, RT_WAITING_FOREVER);
+    if (records == RT_NULL) {
+        ingest_stats.rejected++;
+        return;
+    }
+    db_batch_begin(&batch, records, SEAT_INGEST_FRAME_MAX);
+
+    for (char *item = strtok_r(frame, ";", &save); item; item = strtok_r(RT_NULL, ";", &save)) {
+        char *sep = strchr(item, ':');
+        if (sep == RT_NULL) {
+            batch.rejected++;
+            continue;
+        }
+        *sep = '\0';
+
+        rt_uint16_t seat_id = parse_seat_id(item);
+        if (seat_id == 0) {
+            batch.rejected++;
+            continue;
+        }
+        if (db_batch_apply(&batch, seat_id, str_to_seat_status(sep + 1)) == RT_EOK) {
+            last_id = item;
+            last_status = sep + 1;
+        }
+    }
+
+    db_batch_commit(&batch);
+    mem_pool_free(&seat_ingest_pool, records);
+    /* 库满的记录已计入rejected，records只计写入的 */
+    ingest_stats.records += batch.committed;
+    ingest_stats.rejected += batch.rejected;
+
+    // 显示帧内最后一条有效记录
+    if (last_id) {
+        strncpy(g_seat_data.seat_id, last_id, sizeof(g_seat_data.seat_id) - 1);
+        strncpy(g_seat_data.status, last_status, sizeof(g_seat_data.status) - 1);
+        g_seat_data.new_data = RT_TRUE;
+        ui_event_post(UI_EVT_SEAT_SELECTED);
+    }
+}
+
+static seat_ingest_source_t *ingest_find_source(rt_uint32_t addr, rt_uint16_t port)
+{
+    for (rt_uint16_t i = 0; i < ingest_stats.source_count; i++) {
+        if (ingest_sources[i].addr == addr && ingest_sources[i].port == port) {
+            return &ingest_sources[i];
+        }
+    }
+    if (ingest_stats.source_count < SEAT_INGEST_SOURCES) {
+        seat_ingest_source_t *src = &ingest_sources[ingest_stats.source_count++];
+        rt_memset(src, 0, sizeof(*src));
+        src->addr = addr;
+        src->port = port;
+        return src;
+    }
+    return RT_NULL;
+}
+
+/* 按来源跟踪序号：跳号计为丢失，迟到的包回补一次丢失 */
+static void ingest_track_seq(rt_uint32_t addr, rt_uint16_t port, rt_uint32_t seq)
+{
+    seat_ingest_source_t *src = ingest_find_source(addr, port);
+    rt_int32_t gap;
+
+    if (src == RT_NULL) {
+        ingest_stats.untracked++;
+        return;
+    }
+
+    gap = (rt_int32_t)(seq - src->next_seq);
+    if (src->datagrams > 0 && gap < 0) {
+        if (gap > -INGEST_SEQ_RESTART_GAP) {
+            src->datagrams++;
+            src->late++;
+            if (src->lost > 0) {
+                src->lost--;
+            }
+            return;
+        }
+        src->restarts++;
+    } else if (src->datagrams > 0) {
+        src->lost += gap;
+    }
+
+    src->datagrams++;
+    src->next_seq = seq + 1;
+}
+
+void seat_ingest_init(void)
+{
+    rt_mutex_init(&ingest_lock, "ingest", RT_IPC_FLAG_PRIO);
+}
+
+static void ingest_datagram(char *buf, rt_uint32_t addr, rt_uint16_t port)
+{
+    char *payload = buf;
+
+    ingest_stats.datagrams++;
+
+    /* 解析会就地改写buf，先按原文记录 */
+    seat_trace_capture(buf, strlen(buf), addr, port);
+
+    /* 可选序号头"#<seq>;"，按来源统计丢包与乱序 */
+    if (buf[0] == '#') {
+        char *end;
+        rt_uint32_t seq = strtoul(buf + 1, &end, 10);
+
+        if (end == buf + 1 || *end != ';') {
+            ingest_stats.rejected++;
+            return;
+        }
+        ingest_track_seq(addr, port, seq);
+        payload = end + 1;
+    }
+
+    /* 批量帧 "座位ID:状态;座位ID:状态;..." 整帧一次提交 */
+    if (strchr(payload, ';') != RT_NULL) {
+        update_database_from_frame(payload);
+        return;
+    }
+
+    /* 解析字符串格式 "座位ID:状态" */
+    char *save = RT_NULL;
+    char *token = strtok_r(payload, ":", &save);
+    if (token) {
+        char seat_id[10] = {0};
+        char status[10] = {0};
+        strncpy(seat_id, token, sizeof(seat_id) - 1);
+
+        token = strtok_r(RT_NULL, ":", &save);
+        if (token) {
+            strncpy(status, token, sizeof(status) - 1);
+
+            // 调用数据库更新函数
+            update_database_from_udp(seat_id, status);
+            return;
+        }
+    }
+    ingest_stats.rejected++;
+}
+
+void seat_ingest_datagram(char *buf, rt_uint32_t addr, rt_uint16_t port)
+{
+    rt_mutex_take(&ingest_lock, RT_WAITING_FOREVER);
+    ingest_datagram(buf, addr, port);
+    rt_mutex_release(&ingest_lock);
+}
+
+void seat_ingest_get_stats(seat_ingest_stats_t *out)
+{
+    rt_mutex_take(&ingest_lock, RT_WAITING_FOREVER);
+    *out = ingest_stats;
+    rt_mutex_release(&ingest_lock);
+}
+
+const seat_ingest_source_t *seat_ingest_get_source(rt_uint16_t index)
+{
+    return index < ingest_stats.source_count ? &ingest_sources[index] : RT_NULL;
+}
+
+void seat_ingest_reset_stats(void)
+{
+    rt_mutex_take(&ingest_lock, RT_WAITING_FOREVER);
+    rt_memset(&ingest_stats, 0, sizeof(ingest_stats));
+    rt_memset(ingest_sources, 0, sizeof(ingest_sources));
+    rt_mutex_release(&ingest_lock);
+}
+
+static void ingest_stat(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        seat_ingest_reset_stats();
+        return;
+    }
+
+    rt_kprintf("Datagrams : %d\n", ingest_stats.datagrams);
+    rt_kprintf("Records   : %d\n", ingest_stats.records);
+    rt_kprintf("Rejected  : %d\n", ingest_stats.rejected);
+    rt_kprintf("Untracked : %d\n", ingest_stats.untracked);
+    if (ingest_stats.source_count == 0) {
+        return;
+    }
+
+    rt_kprintf("%-15s %5s %9s %7s %6s %4s\n", "source", "port", "datagrams", "lost", "late", "rst");
+    for (rt_uint16_t i = 0; i < ingest_stats.source_count; i++) {
+        seat_ingest_source_t *src = &ingest_sources[i];
+        rt_uint8_t *ip = (rt_uint8_t *)&src->addr;
+        char addr[16];
+
+        rt_snprintf(addr, sizeof(addr), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+        rt_kprintf("%-15s %5d %9d %7d %6d %4d\n", addr, src->port, src->datagrams,
+                   src->lost, src->late, src->restarts);
+    }
+}
+MSH_CMD_EXPORT(ingest_stat, show UDP ingest statistics: ingest_stat [reset]);
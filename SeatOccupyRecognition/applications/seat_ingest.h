@@ -0,0 +1,52 @@
+#ifndef __SEAT_INGEST_H__
+#define __SEAT_INGEST_H__
+
+#include <rtthread.h>
+#include "seat_db.h"
+
+/* 座位数据入口：解析UDP数据报并写入数据库，网络线程与模拟/回放工具共用 */
+
+#ifndef SEAT_INGEST_PORT
+#define SEAT_INGEST_PORT        8080
+#endif
+
+/* 按来源（地址+端口）统计序号的表项数 */
+#ifndef SEAT_INGEST_SOURCES
+#define SEAT_INGEST_SOURCES     8
+#endif
+
+/* 每个发送方的序号统计，数据报以可选的"#<seq>;"开头时才计入 */
+typedef struct {
+    rt_uint32_t addr;           // IPv4地址（网络字节序）
+    rt_uint16_t port;
+    rt_uint32_t datagrams;
+    rt_uint32_t next_seq;       // 期望的下一个序号
+    rt_uint32_t lost;           // 序号缺口累计（迟到的包会回补）
+    rt_uint32_t late;           // 乱序或重复到达
+    rt_uint32_t restarts;       // 序号回绕或发送方重启
+} seat_ingest_source_t;
+
+typedef struct {
+    rt_uint32_t datagrams;
+    rt_uint32_t records;        // 校验通过并提交的记录数
+    rt_uint32_t rejected;       // 格式或取值非法、或库满未能写入的记录数
+    rt_uint32_t untracked;      // 来源表已满未统计序号的数据报
+    rt_uint16_t source_count;
+} seat_ingest_stats_t;
+
+/* 初始化入库锁，须在任何生产者（接收线程、模拟器）启动前调用 */
+void seat_ingest_init(void);
+/* 处理一个以'\0'结尾的数据报，buf会被就地改写；多个线程可同时调用，内部串行化 */
+void seat_ingest_datagram(char *buf, rt_uint32_t addr, rt_uint16_t port);
+
+/* 单条记录"座位ID:状态"与批量帧"ID:状态;ID:状态;..."的解析入口，
+ * 由seat_ingest_datagram在入库锁内调用 */
+void update_database_from_udp(const char *seat_id_str, const char *status_str);
+void update_database_from_frame(char *frame);
+
+void seat_ingest_get_stats(seat_ingest_stats_t *out);
+/* 按下标读取来源统计，越界返回RT_NULL */
+const seat_ingest_source_t *seat_ingest_get_source(rt_uint16_t index);
+void seat_ingest_reset_stats(void);
+
+#endif
@@ -0,0 +1,412 @@
+#include <rtthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "seat_scenario.h"
+#include "seat_db.h"
+
+#define HM(h, m)        ((h) * 3600 + (m) * 60)
+#define MIN(m)          ((m) * 60)
+
+/* 单个数据报最多携带的记录数，保证不超过接收缓冲与SEAT_INGEST_FRAME_MAX */
+#define SCN_RECORDS_PER_DATAGRAM    32
+#define SCN_DATAGRAM_MAX            384
+
+/* 座位待执行的动作 */
+enum {
+    SCN_ACT_NONE = 0,
+    SCN_ACT_ARRIVE,
+    SCN_ACT_LEAVE,
+    SCN_ACT_CLAIM,
+    SCN_ACT_RESOLVE,            // 占座结束：回到座位或离开
+};
+
+typedef struct {
+    rt_uint8_t status;          // 真实状态
+    rt_uint8_t reported;        // 上报状态，抖动期间与真实状态不同
+    rt_uint8_t action;
+    rt_uint8_t flapping;
+    rt_uint32_t action_ms;
+    rt_uint32_t hold_ms;        // 动作完成后的保持时长
+    rt_uint32_t flap_until;
+    rt_uint32_t next_flap;
+    rt_uint32_t flap_period;
+    rt_uint32_t mute_until;
+} scn_seat_t;
+
+typedef struct {
+    rt_uint32_t seq;
+    rt_uint16_t count;
+    rt_uint16_t len;
+    rt_uint32_t next_refresh;
+    char buf[SCN_DATAGRAM_MAX];
+} scn_board_t;
+
+static const seat_scenario_t *scn;
+static scn_seat_t seats[SEAT_SCN_MAX_SEATS + 1];    // 下标即座位ID
+static scn_board_t boards[SEAT_SCN_BOARDS];
+static rt_uint16_t seat_count;
+static rt_uint16_t next_event;
+static rt_uint32_t refresh_ms;
+static rt_uint32_t rand_state;
+static seat_scn_emit_t emit_cb;
+static void *emit_arg;
+static seat_scn_stats_t stats;
+
+/* 工作日的一天：早到的长时间自习、课间到达潮、午饭占座、检测抖动、一块识别板掉线、闭馆 */
+static const seat_scn_event_t library_day_events[] = {
+    { HM(7, 0),   MIN(30), SEAT_SCN_ARRIVE,  25,  1, 64, MIN(180) },
+    { HM(8, 50),  MIN(10), SEAT_SCN_ARRIVE,  60,  1, 64, MIN(90)  },
+    { HM(10, 0),  MIN(15), SEAT_SCN_CLAIM,   30,  1, 64, MIN(45)  },
+    { HM(10, 30), MIN(20), SEAT_SCN_FLAP,   100, 33, 40, 2        },
+    { HM(11, 50), MIN(10), SEAT_SCN_ARRIVE,  40,  1, 64, MIN(60)  },
+    { HM(12, 0),  MIN(20), SEAT_SCN_CLAIM,   50,  1, 64, MIN(60)  },
+    { HM(13, 50), MIN(10), SEAT_SCN_ARRIVE,  70,  1, 64, MIN(120) },
+    { HM(15, 0),  MIN(15), SEAT_SCN_DROPOUT,100, 17, 32, 0        },
+    { HM(15, 50), MIN(10), SEAT_SCN_ARRIVE,  50,  1, 64, MIN(90)  },
+    { HM(17, 30), MIN(30), SEAT_SCN_DEPART,  40,  1, 64, 0        },
+    { HM(18, 0),  MIN(30), SEAT_SCN_CLAIM,   25,  1, 64, MIN(60)  },
+    { HM(19, 0),  MIN(15), SEAT_SCN_ARRIVE,  40,  1, 64, MIN(150) },
+    { HM(21, 45), MIN(15), SEAT_SCN_DEPART, 100,  1, 64, 0        },
+};
+
+const seat_scenario_t seat_scenario_library_day = {
+    library_day_events, RT_ARRAY_SIZE(library_day_events), HM(7, 0), HM(22, 0)
+};
+
+static const char *const kind_names[SEAT_SCN_KIND_NUM] = {
+    "arrive", "depart", "claim", "flap", "dropout"
+};
+
+static rt_uint32_t scn_rand(rt_uint32_t n)
+{
+    rand_state = rand_state * 1103515245 + 12345;
+    return n ? (rand_state >> 8) % n : 0;
+}
+
+/* 保持时长在0.5~1.5倍之间随机 */
+static rt_uint32_t scn_vary(rt_uint32_t ms)
+{
+    return ms / 2 + scn_rand(ms + 1);
+}
+
+static void board_flush(rt_uint16_t b)
+{
+    scn_board_t *board = &boards[b];
+
+    if (board->count == 0) {
+        return;
+    }
+    stats.datagrams++;
+    emit_cb(board->buf, b, emit_arg);
+    board->count = 0;
+    board->len = 0;
+}
+
+/* 追加一条记录，数据报满时先发出 */
+static void board_report(rt_uint16_t id, rt_uint8_t status)
+{
+    rt_uint16_t b = (id - 1) / SEAT_SCN_SEATS_PER_BOARD;
+    scn_board_t *board = &boards[b];
+    char rec[16];
+    int n = rt_snprintf(rec, sizeof(rec), "A%02d:%d", id, status);
+
+    if (board->count == SCN_RECORDS_PER_DATAGRAM || board->len + n + 1 >= SCN_DATAGRAM_MAX) {
+        board_flush(b);
+    }
+    if (board->count == 0) {
+        board->len = rt_snprintf(board->buf, SCN_DATAGRAM_MAX, "#%d;", board->seq++);
+    } else {
+        board->buf[board->len++] = ';';
+    }
+    rt_memcpy(&board->buf[board->len], rec, n + 1);
+    board->len += n;
+    board->count++;
+    stats.reports++;
+}
+
+static rt_bool_t seat_muted(const scn_seat_t *seat, rt_uint32_t now)
+{
+    return (rt_int32_t)(seat->mute_until - now) > 0;
+}
+
+/* 事件窗口开始：按比例挑选座位并排定各自的动作时刻 */
+static void scn_start_event(const seat_scn_event_t *ev)
+{
+    rt_uint32_t at = ev->at > scn->begin ? (ev->at - scn->begin) * 1000 : 0;
+    rt_uint32_t window = ev->window * 1000;
+    rt_uint16_t last = ev->last_seat < seat_count ? ev->last_seat : seat_count;
+
+    for (rt_uint16_t id = ev->first_seat; id <= last; id++) {
+        scn_seat_t *seat = &seats[id];
+
+        if (scn_rand(100) >= ev->percent) {
+            continue;
+        }
+
+        switch (ev->kind) {
+        case SEAT_SCN_ARRIVE:
+            if (seat->status != SEAT_AVAILABLE || seat->action != SCN_ACT_NONE) {
+                continue;
+            }
+            seat->action = SCN_ACT_ARRIVE;
+            seat->action_ms = at + scn_rand(window);
+            seat->hold_ms = scn_vary(ev->hold * 1000);
+            break;
+        case SEAT_SCN_DEPART:
+            if (seat->status == SEAT_AVAILABLE && seat->action != SCN_ACT_ARRIVE) {
+                continue;
+            }
+            seat->action = SCN_ACT_LEAVE;
+            seat->action_ms = at + scn_rand(window);
+            break;
+        case SEAT_SCN_CLAIM:
+            if (seat->status != SEAT_OCCUPIED) {
+                continue;
+            }
+            seat->action = SCN_ACT_CLAIM;
+            seat->action_ms = at + scn_rand(window);
+            seat->hold_ms = scn_vary(ev->hold * 1000);
+            break;
+        case SEAT_SCN_FLAP:
+            if (ev->hold == 0) {
+                continue;
+            }
+            seat->flapping = 1;
+            seat->flap_period = ev->hold * 1000;
+            seat->flap_until = at + window;
+            seat->next_flap = at + scn_rand(seat->flap_period);
+            break;
+        case SEAT_SCN_DROPOUT:
+            seat->mute_until = at + window;
+            break;
+        default:
+            continue;
+        }
+        stats.kinds[ev->kind]++;
+    }
+}
+
+static void scn_run_action(scn_seat_t *seat, rt_uint32_t now)
+{
+    rt_uint8_t action = seat->action;
+
+    seat->action = SCN_ACT_NONE;
+    switch (action) {
+    case SCN_ACT_ARRIVE:
+        if (seat->status == SEAT_AVAILABLE) {
+            seat->status = SEAT_OCCUPIED;
+            seat->action = SCN_ACT_LEAVE;
+            seat->action_ms = now + seat->hold_ms;
+        }
+        break;
+    case SCN_ACT_LEAVE:
+        seat->status = SEAT_AVAILABLE;
+        break;
+    case SCN_ACT_CLAIM:
+        if (seat->status == SEAT_OCCUPIED) {
+            seat->status = SEAT_CLAIMED;
+            seat->action = SCN_ACT_RESOLVE;
+            seat->action_ms = now + seat->hold_ms;
+        }
+        break;
+    case SCN_ACT_RESOLVE:
+        /* 一半回到座位继续自习，一半直接离开 */
+        if (seat->status == SEAT_CLAIMED && scn_rand(2)) {
+            seat->status = SEAT_OCCUPIED;
+            seat->action = SCN_ACT_LEAVE;
+            seat->action_ms = now + seat->hold_ms;
+        } else {
+            seat->status = SEAT_AVAILABLE;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void scn_step_seat(rt_uint16_t id, rt_uint32_t now)
+{
+    scn_seat_t *seat = &seats[id];
+    rt_uint8_t before = seat->status;
+    rt_bool_t muted = seat_muted(seat, now);
+
+    if (seat->action != SCN_ACT_NONE && (rt_int32_t)(now - seat->action_ms) >= 0) {
+        scn_run_action(seat, now);
+    }
+    if (seat->status != before) {
+        stats.changes++;
+        if (muted) {
+            stats.muted++;
+        }
+    }
+
+    if (seat->flapping) {
+        if ((rt_int32_t)(now - seat->flap_until) >= 0) {
+            seat->flapping = 0;
+        } else {
+            /* 抖动：上报状态在使用中与空闲之间翻转，真实状态不变 */
+            while ((rt_int32_t)(now - seat->next_flap) >= 0) {
+                seat->reported = seat->reported == SEAT_AVAILABLE ? SEAT_OCCUPIED : SEAT_AVAILABLE;
+                seat->next_flap += scn_vary(seat->flap_period);
+                if (!muted) {
+                    board_report(id, seat->reported);
+                }
+            }
+            return;
+        }
+    }
+
+    if (!muted && seat->reported != seat->status) {
+        seat->reported = seat->status;
+        board_report(id, seat->reported);
+    }
+}
+
+rt_err_t seat_scenario_init(const seat_scenario_t *scenario, rt_uint16_t seats_n, rt_uint32_t refresh_s,
+                            rt_uint32_t seed, seat_scn_emit_t emit, void *arg)
+{
+    if (scenario == RT_NULL || emit == RT_NULL || seats_n == 0 || seats_n > SEAT_SCN_MAX_SEATS ||
+        scenario->end <= scenario->begin) {
+        return -RT_EINVAL;
+    }
+    /* 抖动周期为0时翻转循环追不上当前时刻 */
+    for (rt_uint16_t i = 0; i < scenario->event_count; i++) {
+        if (scenario->events[i].kind == SEAT_SCN_FLAP && scenario->events[i].hold == 0) {
+            return -RT_EINVAL;
+        }
+    }
+
+    scn = scenario;
+    seat_count = seats_n;
+    refresh_ms = refresh_s * 1000;
+    rand_state = seed;
+    emit_cb = emit;
+    emit_arg = arg;
+    next_event = 0;
+    rt_memset(seats, 0, sizeof(seats));
+    rt_memset(boards, 0, sizeof(boards));
+    rt_memset(&stats, 0, sizeof(stats));
+
+    /* 初始全部空闲，各板补报时刻在一个周期内错开；reported置为无效值使首次补报前先上报一次 */
+    for (rt_uint16_t id = 1; id <= seat_count; id++) {
+        seats[id].status = SEAT_AVAILABLE;
+        seats[id].reported = SEAT_STATUS_NUM;
+    }
+    for (rt_uint16_t b = 0; b < SEAT_SCN_BOARDS; b++) {
+        boards[b].next_refresh = refresh_ms * b / SEAT_SCN_BOARDS;
+    }
+    return RT_EOK;
+}
+
+void seat_scenario_step(rt_uint32_t now_ms)
+{
+    while (next_event < scn->event_count) {
+        const seat_scn_event_t *ev = &scn->events[next_event];
+        rt_uint32_t at = ev->at > scn->begin ? (ev->at - scn->begin) * 1000 : 0;
+
+        if (at > now_ms) {
+            break;
+        }
+        scn_start_event(ev);
+        next_event++;
+    }
+
+    for (rt_uint16_t id = 1; id <= seat_count; id++) {
+        scn_step_seat(id, now_ms);
+    }
+
+    /* 整板补报：识别板周期性重发全部座位的当前状态，掉线的座位不报 */
+    if (refresh_ms) {
+        for (rt_uint16_t b = 0; b < SEAT_SCN_BOARDS; b++) {
+            rt_uint16_t first = b * SEAT_SCN_SEATS_PER_BOARD + 1;
+
+            if (first > seat_count || (rt_int32_t)(now_ms - boards[b].next_refresh) < 0) {
+                continue;
+            }
+            boards[b].next_refresh += refresh_ms;
+            for (rt_uint16_t id = first; id < first + SEAT_SCN_SEATS_PER_BOARD && id <= seat_count; id++) {
+                if (!seat_muted(&seats[id], now_ms) && seats[id].reported < SEAT_STATUS_NUM) {
+                    board_report(id, seats[id].reported);
+                }
+            }
+        }
+    }
+
+    for (rt_uint16_t b = 0; b < SEAT_SCN_BOARDS; b++) {
+        board_flush(b);
+    }
+}
+
+rt_uint32_t seat_scenario_length_ms(void)
+{
+    return scn ? (scn->end - scn->begin) * 1000 : 0;
+}
+
+void seat_scenario_get_stats(seat_scn_stats_t *out)
+{
+    *out = stats;
+}
+
+/* 时长：数字加可选后缀s/m/h */
+static const char *parse_duration(const char *s, rt_uint32_t *out)
+{
+    char *end;
+    rt_uint32_t v = strtoul(s, &end, 10);
+
+    if (end == s) {
+        return RT_NULL;
+    }
+    switch (*end) {
+    case 'h': v *= 3600; end++; break;
+    case 'm': v *= 60; end++; break;
+    case 's': end++; break;
+    default: break;
+    }
+    *out = v;
+    return end;
+}
+
+rt_err_t seat_scenario_parse_line(const char *line, seat_scn_event_t *ev)
+{
+    char kind[12];
+    unsigned int hh, mm, first, last, percent;
+    char window[12], hold[12];
+    int n;
+
+    while (*line == ' ' || *line == '\t') {
+        line++;
+    }
+    if (*line == '\0' || *line == '\n' || *line == '\r' || *line == '#') {
+        return -RT_EEMPTY;
+    }
+
+    n = sscanf(line, "%u:%u %11s %11s %u-%u %u %11s", &hh, &mm, window, kind,
+               &first, &last, &percent, hold);
+    if (n < 7 || hh > 23 || mm > 59 || first == 0 || last < first || percent > 100) {
+        return -RT_EINVAL;
+    }
+
+    rt_memset(ev, 0, sizeof(*ev));
+    ev->at = HM(hh, mm);
+    ev->first_seat = first;
+    ev->last_seat = last;
+    ev->percent = percent;
+    if (parse_duration(window, &ev->window) == RT_NULL ||
+        (n == 8 && parse_duration(hold, &ev->hold) == RT_NULL)) {
+        return -RT_EINVAL;
+    }
+
+    for (n = 0; n < SEAT_SCN_KIND_NUM; n++) {
+        if (strcmp(kind, kind_names[n]) == 0) {
+            ev->kind = n;
+            /* 抖动必须给出非零的翻转周期 */
+            if (ev->kind == SEAT_SCN_FLAP && ev->hold == 0) {
+                return -RT_EINVAL;
+            }
+            return RT_EOK;
+        }
+    }
+    return -RT_EINVAL;
+}
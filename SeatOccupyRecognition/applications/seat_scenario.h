@@ -0,0 +1,76 @@
+#ifndef __SEAT_SCENARIO_H__
+#define __SEAT_SCENARIO_H__
+
+#include <rtthread.h>
+
+/* 场景模拟引擎：按声明式场景表模拟图书馆一天的客流（到达潮、长时间自习、
+ * 占座后离开、检测抖动、识别板掉线），把状态变化编码成识别板数据报交给输出回调。
+ * 引擎只依赖调用方给出的场景时间，主机上可远快于实时运行 */
+
+#ifndef SEAT_SCN_MAX_SEATS
+#define SEAT_SCN_MAX_SEATS      64
+#endif
+
+#ifndef SEAT_SCN_MAX_EVENTS
+#define SEAT_SCN_MAX_EVENTS     32
+#endif
+
+/* 每块识别板负责的座位数，板号决定数据报的源端口 */
+#define SEAT_SCN_SEATS_PER_BOARD    16
+#define SEAT_SCN_BOARDS     ((SEAT_SCN_MAX_SEATS + SEAT_SCN_SEATS_PER_BOARD - 1) / SEAT_SCN_SEATS_PER_BOARD)
+
+typedef enum {
+    SEAT_SCN_ARRIVE = 0,        // 窗口内按比例有人入座，保持hold（±50%）后离开
+    SEAT_SCN_DEPART,            // 窗口内按比例离座
+    SEAT_SCN_CLAIM,             // 使用中的座位按比例转为占座，hold后回来或离开
+    SEAT_SCN_FLAP,              // 检测抖动：上报状态以hold为周期来回翻转
+    SEAT_SCN_DROPOUT,           // 识别板掉线：窗口内不上报
+    SEAT_SCN_KIND_NUM,
+} seat_scn_kind_t;
+
+/* 场景表中的一条事件，时间均为当天的秒数 */
+typedef struct {
+    rt_uint32_t at;             // 窗口开始
+    rt_uint32_t window;         // 窗口长度
+    rt_uint8_t kind;            // seat_scn_kind_t
+    rt_uint8_t percent;         // 受影响座位比例
+    rt_uint16_t first_seat;
+    rt_uint16_t last_seat;
+    rt_uint32_t hold;           // 保持时长，FLAP为翻转周期
+} seat_scn_event_t;
+
+typedef struct {
+    const seat_scn_event_t *events;     // 按at升序
+    rt_uint16_t event_count;
+    rt_uint32_t begin;          // 模拟开始时刻（当天秒数）
+    rt_uint32_t end;
+} seat_scenario_t;
+
+/* 输出回调：一个以'\0'结尾的数据报及其识别板号 */
+typedef void (*seat_scn_emit_t)(char *datagram, rt_uint16_t board, void *arg);
+
+typedef struct {
+    rt_uint32_t datagrams;
+    rt_uint32_t reports;        // 上报的座位记录
+    rt_uint32_t changes;        // 真实状态变化
+    rt_uint32_t muted;          // 掉线期间未上报的变化
+    rt_uint32_t kinds[SEAT_SCN_KIND_NUM];   // 各类事件实际作用的座位次数
+} seat_scn_stats_t;
+
+/* 内置场景：工作日的一天，07:00开馆至22:00闭馆 */
+extern const seat_scenario_t seat_scenario_library_day;
+
+/* 初始化引擎：seats个座位（ID从1开始），每refresh_s秒整板补报一次全部座位 */
+rt_err_t seat_scenario_init(const seat_scenario_t *scn, rt_uint16_t seats, rt_uint32_t refresh_s,
+                            rt_uint32_t seed, seat_scn_emit_t emit, void *arg);
+/* 推进到场景时间now_ms（自begin起的毫秒数），处理期间到期的全部事件 */
+void seat_scenario_step(rt_uint32_t now_ms);
+/* 场景总时长（毫秒） */
+rt_uint32_t seat_scenario_length_ms(void);
+void seat_scenario_get_stats(seat_scn_stats_t *out);
+
+/* 解析一行场景文本 "HH:MM 窗口 类型 首座-末座 比例 保持"，窗口与保持带s/m/h后缀，
+ * 例如 "08:50 10m arrive 1-64 60 90m"；空行与#注释返回-RT_EEMPTY */
+rt_err_t seat_scenario_parse_line(const char *line, seat_scn_event_t *ev);
+
+#endif
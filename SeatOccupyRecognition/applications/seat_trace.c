@@ -0,0 +1,253 @@
+#include <rtthread.h>
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "seat_trace.h"
+#include "mem_pool.h"
+
+#define DBG_TAG "trace"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+/* 变长记录的环形区：head为写入位置，tail为最旧记录起点，记录可跨越末尾回绕 */
+static rt_uint8_t trace_ram[SEAT_TRACE_RAM_SIZE];
+static rt_size_t trace_head;
+static rt_size_t trace_tail;
+static rt_size_t trace_used;
+
+static volatile seat_trace_mode_t trace_mode = SEAT_TRACE_OFF;
+static seat_trace_sink_t trace_sink;
+static void *trace_sink_arg;
+static seat_trace_stats_t trace_stats;
+static struct rt_mutex trace_lock;
+static mem_pool_t trace_pool;
+/* 记录头与原文拼成一块交给输出端，持trace_lock使用，不放在调用线程栈上 */
+static rt_uint8_t trace_out[sizeof(seat_trace_rec_t) + SEAT_TRACE_PAYLOAD_MAX];
+
+static void ring_write(const void *data, rt_size_t len)
+{
+    const rt_uint8_t *p = data;
+    rt_size_t first = SEAT_TRACE_RAM_SIZE - trace_head;
+
+    if (first > len) {
+        first = len;
+    }
+    rt_memcpy(&trace_ram[trace_head], p, first);
+    rt_memcpy(trace_ram, p + first, len - first);
+    trace_head = (trace_head + len) % SEAT_TRACE_RAM_SIZE;
+    trace_used += len;
+}
+
+static void ring_read(rt_size_t pos, void *data, rt_size_t len)
+{
+    rt_uint8_t *p = data;
+    rt_size_t first = SEAT_TRACE_RAM_SIZE - pos;
+
+    if (first > len) {
+        first = len;
+    }
+    rt_memcpy(p, &trace_ram[pos], first);
+    rt_memcpy(p + first, trace_ram, len - first);
+}
+
+/* 丢弃最旧记录，直到能放下need字节 */
+static void ring_make_room(rt_size_t need)
+{
+    while (SEAT_TRACE_RAM_SIZE - trace_used < need) {
+        seat_trace_rec_t rec;
+        rt_size_t size;
+
+        ring_read(trace_tail, &rec, sizeof(rec));
+        size = sizeof(rec) + rec.len;
+        trace_tail = (trace_tail + size) % SEAT_TRACE_RAM_SIZE;
+        trace_used -= size;
+        trace_stats.overwritten++;
+    }
+}
+
+static void trace_reset_ram(void)
+{
+    trace_head = 0;
+    trace_tail = 0;
+    trace_used = 0;
+    mem_pool_note_usage(&trace_pool, 0);
+}
+
+void seat_trace_init(void)
+{
+    rt_mutex_init(&trace_lock, "trace", RT_IPC_FLAG_PRIO);
+    mem_pool_register(&trace_pool, "trace_ram", 1, SEAT_TRACE_RAM_SIZE);
+    trace_reset_ram();
+}
+
+void seat_trace_start_ram(void)
+{
+    rt_mutex_take(&trace_lock, RT_WAITING_FOREVER);
+    trace_reset_ram();
+    rt_memset(&trace_stats, 0, sizeof(trace_stats));
+    trace_mode = SEAT_TRACE_RAM;
+    rt_mutex_release(&trace_lock);
+}
+
+void seat_trace_start_stream(seat_trace_sink_t sink, void *arg)
+{
+    seat_trace_file_t file = { SEAT_TRACE_MAGIC, RT_TICK_PER_SECOND };
+
+    rt_mutex_take(&trace_lock, RT_WAITING_FOREVER);
+    rt_memset(&trace_stats, 0, sizeof(trace_stats));
+    trace_sink = sink;
+    trace_sink_arg = arg;
+    sink(&file, sizeof(file), arg);
+    trace_mode = SEAT_TRACE_STREAM;
+    rt_mutex_release(&trace_lock);
+}
+
+void seat_trace_stop(void)
+{
+    rt_mutex_take(&trace_lock, RT_WAITING_FOREVER);
+    trace_mode = SEAT_TRACE_OFF;
+    trace_sink = RT_NULL;
+    rt_mutex_release(&trace_lock);
+}
+
+void seat_trace_capture(const char *buf, rt_size_t len, rt_uint32_t addr, rt_uint16_t port)
+{
+    seat_trace_rec_t rec;
+
+    if (trace_mode == SEAT_TRACE_OFF) {
+        return;
+    }
+
+    if (len > SEAT_TRACE_PAYLOAD_MAX) {
+        len = SEAT_TRACE_PAYLOAD_MAX;
+        trace_stats.truncated++;
+    }
+    rec.tick = rt_tick_get();
+    rec.addr = addr;
+    rec.port = port;
+    rec.len = len;
+
+    rt_mutex_take(&trace_lock, RT_WAITING_FOREVER);
+    if (trace_mode == SEAT_TRACE_RAM) {
+        ring_make_room(sizeof(rec) + len);
+        ring_write(&rec, sizeof(rec));
+        ring_write(buf, len);
+        mem_pool_note_usage(&trace_pool, trace_used);
+        trace_stats.captured++;
+    } else if (trace_mode == SEAT_TRACE_STREAM) {
+        /* 流式接收端按块追加即为追踪文件 */
+        rt_memcpy(trace_out, &rec, sizeof(rec));
+        rt_memcpy(trace_out + sizeof(rec), buf, len);
+        trace_sink(trace_out, sizeof(rec) + len, trace_sink_arg);
+        trace_stats.captured++;
+    }
+    rt_mutex_release(&trace_lock);
+}
+
+void seat_trace_ram_read(seat_trace_sink_t sink, void *arg)
+{
+    seat_trace_file_t file = { SEAT_TRACE_MAGIC, RT_TICK_PER_SECOND };
+    rt_size_t pos, left;
+
+    sink(&file, sizeof(file), arg);
+
+    rt_mutex_take(&trace_lock, RT_WAITING_FOREVER);
+    for (pos = trace_tail, left = trace_used; left > 0; ) {
+        seat_trace_rec_t rec;
+        rt_size_t size;
+
+        ring_read(pos, &rec, sizeof(rec));
+        size = sizeof(rec) + rec.len;
+        rt_memcpy(trace_out, &rec, sizeof(rec));
+        ring_read((pos + sizeof(rec)) % SEAT_TRACE_RAM_SIZE, trace_out + sizeof(rec), rec.len);
+        sink(trace_out, size, arg);
+
+        pos = (pos + size) % SEAT_TRACE_RAM_SIZE;
+        left -= size;
+    }
+    rt_mutex_release(&trace_lock);
+}
+
+void seat_trace_get_stats(seat_trace_stats_t *out)
+{
+    *out = trace_stats;
+    out->mode = trace_mode;
+    out->ram_used = trace_used;
+}
+
+#if defined(RT_USING_FINSH) && defined(RT_USING_SAL)
+
+/* 流式输出：每条记录一个UDP数据报，主机端按接收顺序追加即得追踪文件，
+ * 例如 nc -u -l 9090 > trace.bin */
+static int stream_sock = -1;
+static struct sockaddr_in stream_dest;
+
+static void stream_sink(const void *data, rt_size_t len, void *arg)
+{
+    sendto(stream_sock, data, len, 0, (struct sockaddr *)&stream_dest, sizeof(stream_dest));
+}
+
+/* 以十六进制逐条打印，每行一条记录，主机端用 xxd -r -p 还原为追踪文件 */
+static void dump_sink(const void *data, rt_size_t len, void *arg)
+{
+    const rt_uint8_t *p = data;
+
+    for (rt_size_t i = 0; i < len; i++) {
+        rt_kprintf("%02x", p[i]);
+    }
+    rt_kprintf("\n");
+}
+
+static void trace_stream_close(void)
+{
+    if (stream_sock >= 0) {
+        close(stream_sock);
+        stream_sock = -1;
+    }
+}
+
+static void trace(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "ram") == 0) {
+        seat_trace_stop();
+        trace_stream_close();
+        seat_trace_start_ram();
+    } else if (argc > 2 && strcmp(argv[1], "stream") == 0) {
+        seat_trace_stop();
+        trace_stream_close();
+
+        rt_memset(&stream_dest, 0, sizeof(stream_dest));
+        stream_dest.sin_family = AF_INET;
+        stream_dest.sin_port = htons(argc > 3 ? atoi(argv[3]) : SEAT_TRACE_STREAM_PORT);
+        stream_dest.sin_addr.s_addr = inet_addr(argv[2]);
+        stream_sock = socket(AF_INET, SOCK_DGRAM, 0);
+        if (stream_sock < 0) {
+            rt_kprintf("Trace stream socket failed\n");
+            return;
+        }
+        seat_trace_start_stream(stream_sink, RT_NULL);
+    } else if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        seat_trace_stop();
+        trace_stream_close();
+    } else if (argc > 1 && strcmp(argv[1], "dump") == 0) {
+        seat_trace_ram_read(dump_sink, RT_NULL);
+    } else if (argc > 1 && strcmp(argv[1], "stat") == 0) {
+        static const char *const modes[] = { "off", "ram", "stream" };
+
+        rt_kprintf("Mode        : %s\n", modes[trace_mode]);
+        rt_kprintf("Captured    : %d\n", trace_stats.captured);
+        rt_kprintf("Overwritten : %d\n", trace_stats.overwritten);
+        rt_kprintf("Truncated   : %d\n", trace_stats.truncated);
+        rt_kprintf("RAM used    : %d / %d bytes\n", trace_used, SEAT_TRACE_RAM_SIZE);
+    } else {
+        rt_kprintf("Usage: trace ram | stream <ip> [port] | stop | dump | stat\n");
+    }
+}
+MSH_CMD_EXPORT(trace, ingest trace capture: trace ram | stream <ip> [port] | stop | dump | stat);
+
+#endif
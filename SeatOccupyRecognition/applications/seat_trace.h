@@ -0,0 +1,64 @@
+#ifndef __SEAT_TRACE_H__
+#define __SEAT_TRACE_H__
+
+#include <rtthread.h>
+
+/* 入口流量追踪：按接收顺序记录每个被接收的数据报及其接收时刻，
+ * 可保存在RAM环形区或逐条输出，主机上用tools/ingest_bench/trace_replay回放 */
+
+#ifndef SEAT_TRACE_RAM_SIZE
+#define SEAT_TRACE_RAM_SIZE     4096
+#endif
+
+/* msh命令trace stream未指定端口时的目标端口 */
+#define SEAT_TRACE_STREAM_PORT  9090
+
+#define SEAT_TRACE_MAGIC        0x31525453  // "STR1"
+#define SEAT_TRACE_PAYLOAD_MAX  384
+
+/* 追踪文件以文件头开始，之后是若干条记录，多字节字段均为小端 */
+typedef struct {
+    rt_uint32_t magic;
+    rt_uint32_t tick_hz;        // 记录中滴答的频率
+} seat_trace_file_t;
+
+/* 记录头，后跟len字节数据报原文（不含结尾'\0'） */
+typedef struct {
+    rt_uint32_t tick;           // 接收时刻
+    rt_uint32_t addr;           // 源IPv4地址（网络字节序）
+    rt_uint16_t port;
+    rt_uint16_t len;
+} seat_trace_rec_t;
+
+typedef enum {
+    SEAT_TRACE_OFF = 0,
+    SEAT_TRACE_RAM,             // 写入RAM环形区，满时覆盖最旧记录
+    SEAT_TRACE_STREAM,          // 每条记录交给输出回调
+} seat_trace_mode_t;
+
+/* 输出回调：data为文件头或一条完整记录（记录头+原文） */
+typedef void (*seat_trace_sink_t)(const void *data, rt_size_t len, void *arg);
+
+typedef struct {
+    seat_trace_mode_t mode;
+    rt_uint32_t captured;       // 已记录的数据报
+    rt_uint32_t overwritten;    // RAM环形区中被覆盖的记录
+    rt_uint32_t truncated;      // 超过SEAT_TRACE_PAYLOAD_MAX被截断的数据报
+    rt_size_t ram_used;         // RAM环形区当前占用字节
+} seat_trace_stats_t;
+
+void seat_trace_init(void);
+/* 开始写入RAM环形区，清空之前的内容 */
+void seat_trace_start_ram(void);
+/* 开始逐条输出，先输出文件头 */
+void seat_trace_start_stream(seat_trace_sink_t sink, void *arg);
+void seat_trace_stop(void);
+
+/* 由seat_ingest在解析前调用，未开启时只有一次判断 */
+void seat_trace_capture(const char *buf, rt_size_t len, rt_uint32_t addr, rt_uint16_t port);
+
+/* 按时间顺序输出RAM环形区内容（文件头+全部记录） */
+void seat_trace_ram_read(seat_trace_sink_t sink, void *arg);
+void seat_trace_get_stats(seat_trace_stats_t *out);
+
+#endif
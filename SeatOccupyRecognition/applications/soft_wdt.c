@@ -1,51 +1,140 @@
 #include "soft_wdt.h"
+#include "mem_pool.h"
 #include <rtthread.h>
 
-/* 软件看门狗线程入口函数 */
-static void soft_wdt_thread_entry(void *parameter)
+/* 监督由单个单次定时器完成：无独立线程，无互斥锁。
+ * 每次唤醒检查全部通道，再按距离最近截止时间的间隔重新装载。
+ * 超时处理会打印并调用回调（抓取复位现场），必须在定时器线程中执行，不能放在SysTick中断里。 */
+#ifndef RT_USING_TIMER_SOFT
+#error "soft_wdt requires RT_USING_TIMER_SOFT"
+#endif
+#define SOFT_WDT_TIMER_FLAG     (RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_SOFT_TIMER)
+
+static mem_pool_t soft_wdt_pool;
+MEM_POOL_STORAGE(soft_wdt_storage, sizeof(soft_wdt_t), SOFT_WDT_MAX_INSTANCES);
+
+/* 触发超时回调 */
+static void soft_wdt_fire(soft_wdt_t *wdt)
 {
-    soft_wdt_t *wdt = (soft_wdt_t *)parameter;
-    rt_uint32_t last_feed = 0;
-
-    while (1) {
-        rt_mutex_take(wdt->mutex, RT_WAITING_FOREVER);  // 修正指针传递
-
-        /* 检查是否需要触发超时 */
-        if (wdt->enabled && (rt_tick_get() - last_feed > wdt->timeout)) {
-            wdt->feed_count++;
-
-            /* 超过复位阈值则触发回调 */
-            if (wdt->feed_count >= wdt->reset_count) {
-                rt_mutex_release(wdt->mutex);  // 修正指针传递
-                rt_kprintf("Software watchdog timeout! Trigger callback\n");
-
-                /* 调用超时回调函数 */
-                if (wdt->callback) {
-                    wdt->callback(wdt->callback_arg);
-                } else {
-                    /* 默认回调：系统复位 */
-                    rt_kprintf("System will reset now\n");
-                    rt_hw_cpu_reset();
-                }
+    rt_kprintf("Software watchdog timeout! Trigger callback\n");
+
+    if (wdt->callback) {
+        wdt->callback(wdt->callback_arg);
+    } else {
+        /* 默认回调：系统复位 */
+        rt_kprintf("System will reset now\n");
+        rt_hw_cpu_reset();
+    }
+}
+
+/* 一次遍历检查全部通道，返回超时通道数；新超时的通道号写入fresh（无则为-1），
+ * 正常通道中距离截止最近的剩余时间写入next */
+static int soft_wdt_check(soft_wdt_t *wdt, int *fresh, rt_tick_t *next)
+{
+    rt_tick_t now = rt_tick_get();
+    rt_uint8_t count = wdt->channel_count;
+    int late = 0;
+
+    *fresh = -1;
+    for (int i = 0; i < count; i++) {
+        soft_wdt_channel_t *ch = &wdt->channels[i];
+        rt_tick_t age = now - ch->last_beat;
+
+        if (age <= ch->deadline) {
+            ch->late = RT_FALSE;
+            if (ch->deadline - age + 1 < *next) {
+                *next = ch->deadline - age + 1;
             }
+            continue;
         }
 
-        last_feed = rt_tick_get();
-        rt_mutex_release(wdt->mutex);  // 修正指针传递
+        late++;
+        /* 同一次超时只报告一次，线程恢复心跳前持续计为不健康 */
+        if (!ch->late) {
+            ch->late = RT_TRUE;
+            ch->missed++;
+            rt_kprintf("Software watchdog: thread '%s' missed heartbeat (%d ms > %d ms)\n",
+                       ch->name, age * 1000 / RT_TICK_PER_SECOND,
+                       ch->deadline * 1000 / RT_TICK_PER_SECOND);
+            if (*fresh < 0) {
+                *fresh = i;
+            }
+        }
+    }
+    return late;
+}
+
+/* 硬件喂狗，仅在软件侧全部健康时调用 */
+static void soft_wdt_kick_hw(soft_wdt_t *wdt)
+{
+    if (wdt->hw_dev) {
+        rt_device_control(wdt->hw_dev, RT_DEVICE_CTRL_WDT_KEEPALIVE, RT_NULL);
+        wdt->hw_kicks++;
+    }
+}
+
+/* 装载下一次唤醒，间隔限制在[SOFT_WDT_MIN_PERIOD_MS, 硬件喂狗间隔]之内 */
+static void soft_wdt_schedule(soft_wdt_t *wdt, rt_tick_t period)
+{
+    rt_tick_t min_period = rt_tick_from_millisecond(SOFT_WDT_MIN_PERIOD_MS);
+
+    if (wdt->hw_dev && period > wdt->hw_interval) {
+        period = wdt->hw_interval;
+    }
+    if (period < min_period) {
+        period = min_period;
+    }
+
+    wdt->period = period;
+    wdt->due = rt_tick_get() + period;
+    rt_timer_control(wdt->timer, RT_TIMER_CTRL_SET_TIME, &period);
+    rt_timer_start(wdt->timer);
+}
 
-        /* 短暂延时，减少CPU占用 */
-        rt_thread_mdelay(100);
+/* 巡检一次，返回距下一次需要检查的间隔 */
+static rt_tick_t soft_wdt_supervise(soft_wdt_t *wdt)
+{
+    rt_tick_t next = wdt->timeout;
+
+    if (wdt->channel_count > 0) {
+        int fresh;
+
+        if (soft_wdt_check(wdt, &fresh, &next) == 0) {
+            soft_wdt_kick_hw(wdt);
+        } else {
+            /* 有线程超时：停止硬件喂狗，回调未复位时由硬件兜底 */
+            wdt->hw_withheld++;
+            if (fresh >= 0) {
+                wdt->expired = fresh;
+                soft_wdt_fire(wdt);
+            }
+        }
+    } else {
+        /* 未注册通道：按soft_wdt_feed的喂狗时刻检查 */
+        rt_tick_t age = rt_tick_get() - wdt->last_feed;
+
+        if (age > wdt->timeout) {
+            wdt->hw_withheld++;
+            wdt->last_feed = rt_tick_get();
+            soft_wdt_fire(wdt);
+        } else {
+            soft_wdt_kick_hw(wdt);
+            next = wdt->timeout - age + 1;
+        }
     }
+    return next;
 }
 
-/* 软件看门狗定时器回调函数 */
+/* 监督定时器回调 */
 static void soft_wdt_timer_callback(void *parameter)
 {
     soft_wdt_t *wdt = (soft_wdt_t *)parameter;
 
-    /* 移除中断上下文中的互斥锁操作 */
-    /* 使用原子操作增加计数，避免在ISR中使用互斥锁 */
-    __sync_fetch_and_add(&wdt->feed_count, 1);
+    wdt->wakeups++;
+    if (!wdt->enabled) {
+        return;
+    }
+    soft_wdt_schedule(wdt, soft_wdt_supervise(wdt));
 }
 
 /* 软件看门狗初始化 */
@@ -53,69 +142,45 @@ soft_wdt_t* soft_wdt_init(const char *name, rt_uint32_t timeout_ms,
                          soft_wdt_callback_t cb, void *arg)
 {
     soft_wdt_t *wdt;
-    rt_err_t result;
 
-    /* 分配内存 */
-    wdt = (soft_wdt_t *)rt_malloc(sizeof(soft_wdt_t));
+    /* 首次使用时初始化实例池 */
+    if (soft_wdt_pool.name == RT_NULL) {
+        mem_pool_init(&soft_wdt_pool, "soft_wdt", soft_wdt_storage, sizeof(soft_wdt_storage),
+                      sizeof(soft_wdt_t));
+    }
+
+    /* 从静态池分配实例 */
+    wdt = (soft_wdt_t *)mem_pool_alloc(&soft_wdt_pool, RT_WAITING_NO);
     if (!wdt) {
-        rt_kprintf("Soft watchdog memory allocate failed\n");
+        rt_kprintf("Soft watchdog pool exhausted\n");
         return RT_NULL;
     }
 
     /* 初始化成员变量 */
-    wdt->timeout = timeout_ms * RT_TICK_PER_SECOND / 1000;  // 毫秒转 tick
-    wdt->feed_count = 0;
-    wdt->reset_count = 2;  // 两次超时触发复位
+    wdt->timeout = rt_tick_from_millisecond(timeout_ms);
+    wdt->last_feed = rt_tick_get();
     wdt->enabled = RT_FALSE;
     wdt->callback = cb;
     wdt->callback_arg = arg;
-
-    /* 创建互斥锁 - 修正：动态分配互斥锁内存 */
-    wdt->mutex = (rt_mutex_t)rt_malloc(sizeof(struct rt_mutex));
-    if (!wdt->mutex) {
-        rt_free(wdt);
-        rt_kprintf("Soft watchdog mutex allocate failed\n");
-        return RT_NULL;
-    }
-
-    /* 初始化互斥锁 */
-    result = rt_mutex_init(wdt->mutex, name, RT_IPC_FLAG_FIFO);
-    if (result != RT_EOK) {
-        rt_free(wdt->mutex);
-        rt_free(wdt);
-        rt_kprintf("Soft watchdog mutex init failed\n");
-        return RT_NULL;
-    }
-
-    /* 创建看门狗线程 */
-    wdt->thread = rt_thread_create(name,
-                                  soft_wdt_thread_entry,
-                                  wdt,
-                                  1024,
-                                  RT_THREAD_PRIORITY_MAX - 2,
-                                  10);
-    if (!wdt->thread) {
-        rt_mutex_detach(wdt->mutex);
-        rt_free(wdt->mutex);
-        rt_free(wdt);
-        rt_kprintf("Soft watchdog thread create failed\n");
-        return RT_NULL;
-    }
-
-    /* 创建超时定时器 */
-    wdt->timer = rt_timer_create(name,
-                                soft_wdt_timer_callback,
-                                wdt,
-                                timeout_ms,
-                                RT_TIMER_FLAG_PERIODIC);
-    if (!wdt->timer) {
-        rt_thread_delete(wdt->thread);
-        rt_mutex_detach(wdt->mutex);
-        rt_free(wdt->mutex);
-        rt_free(wdt);
-        rt_kprintf("Soft watchdog timer create failed\n");
-        return RT_NULL;
-    }
+    wdt->channel_count = 0;
+    wdt->expired = -1;
+    wdt->hw_dev = RT_NULL;
+    wdt->hw_interval = 0;
+    wdt->hw_kicks = 0;
+    wdt->hw_withheld = 0;
+    wdt->wakeups = 0;
+    wdt->period = 0;
+    wdt->due = 0;
+    wdt->start_tick = 0;
+
+    /* 初始化监督定时器 */
+    wdt->timer = &wdt->timer_obj;
+    rt_timer_init(wdt->timer,
+                  name,
+                  soft_wdt_timer_callback,
+                  wdt,
+                  wdt->timeout,
+                  SOFT_WDT_TIMER_FLAG);
 
     rt_kprintf("Software watchdog initialized successfully\n");
     return wdt;
@@ -126,13 +191,13 @@ rt_err_t soft_wdt_start(soft_wdt_t *wdt)
 {
     if (!wdt) return -RT_ERROR;
 
-    rt_mutex_take(wdt->mutex, RT_WAITING_FOREVER);  // 修正指针传递
+    wdt->last_feed = rt_tick_get();
+    wdt->start_tick = rt_tick_get();
+    wdt->wakeups = 0;
     wdt->enabled = RT_TRUE;
-    wdt->feed_count = 0;
-    rt_mutex_release(wdt->mutex);  // 修正指针传递
 
-    rt_thread_startup(wdt->thread);
-    rt_timer_start(wdt->timer);
+    /* 首次巡检后即按各通道截止时间自适应 */
+    soft_wdt_schedule(wdt, 0);
 
     rt_kprintf("Software watchdog started\n");
     return RT_EOK;
@@ -143,43 +208,142 @@ rt_err_t soft_wdt_stop(soft_wdt_t *wdt)
 {
     if (!wdt) return -RT_ERROR;
 
-    rt_mutex_take(wdt->mutex, RT_WAITING_FOREVER);  // 修正指针传递
     wdt->enabled = RT_FALSE;
-    rt_mutex_release(wdt->mutex);  // 修正指针传递
-
     rt_timer_stop(wdt->timer);
-    rt_thread_delete(wdt->thread);
 
     rt_kprintf("Software watchdog stopped\n");
     return RT_EOK;
 }
 
-/* 喂狗操作 */
+/* 喂狗操作：32位写入为原子操作，无需加锁 */
 rt_err_t soft_wdt_feed(soft_wdt_t *wdt)
 {
     if (!wdt) return -RT_ERROR;
 
-    rt_mutex_take(wdt->mutex, RT_WAITING_FOREVER);  // 修正指针传递
-    wdt->feed_count = 0;
-    rt_mutex_release(wdt->mutex);  // 修正指针传递
+    wdt->last_feed = rt_tick_get();
+
+    return RT_EOK;
+}
+
+/* 注册心跳通道：关中断期间占用槽位，填好后再发布通道数，定时器回调无需加锁读取 */
+int soft_wdt_register(soft_wdt_t *wdt, const char *name, rt_uint32_t deadline_ms)
+{
+    rt_tick_t deadline = rt_tick_from_millisecond(deadline_ms);
+    rt_base_t level;
+    int ch;
+
+    if (!wdt) return -RT_ERROR;
+
+    level = rt_hw_interrupt_disable();
+    ch = wdt->channel_count;
+    if (ch >= SOFT_WDT_MAX_CHANNELS) {
+        rt_hw_interrupt_enable(level);
+        rt_kprintf("Soft watchdog channels exhausted, '%s' not registered\n", name);
+        return -RT_EFULL;
+    }
+
+    wdt->channels[ch].name = name;
+    wdt->channels[ch].deadline = deadline;
+    wdt->channels[ch].missed = 0;
+    wdt->channels[ch].late = RT_FALSE;
+    wdt->channels[ch].last_beat = rt_tick_get();
+    wdt->channel_count = ch + 1;
+
+    /* 新通道截止早于已装载的唤醒时刻时提前唤醒 */
+    if (wdt->enabled && (rt_int32_t)(wdt->due - rt_tick_get()) > (rt_int32_t)(deadline + 1)) {
+        soft_wdt_schedule(wdt, deadline + 1);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return ch;
+}
+
+/* 接入硬件看门狗，超时按秒向上取整 */
+rt_err_t soft_wdt_attach_hw(soft_wdt_t *wdt, const char *device_name)
+{
+    rt_device_t dev;
+    rt_uint32_t timeout_s;
+
+    if (!wdt) return -RT_ERROR;
+
+    dev = rt_device_find(device_name);
+    if (dev == RT_NULL) {
+        rt_kprintf("Hardware watchdog '%s' not found\n", device_name);
+        return -RT_ENOSYS;
+    }
+
+    timeout_s = (wdt->timeout + RT_TICK_PER_SECOND - 1) / RT_TICK_PER_SECOND;
+    if (timeout_s == 0) {
+        timeout_s = 1;
+    }
 
+    if (rt_device_init(dev) != RT_EOK ||
+        rt_device_control(dev, RT_DEVICE_CTRL_WDT_SET_TIMEOUT, &timeout_s) != RT_EOK) {
+        rt_kprintf("Hardware watchdog '%s' setup failed\n", device_name);
+        return -RT_ERROR;
+    }
+
+    /* 先发布设备再启动，下一次唤醒即开始喂狗；唤醒间隔不超过硬件超时的一半 */
+    wdt->hw_interval = timeout_s * RT_TICK_PER_SECOND / 2;
+    wdt->hw_dev = dev;
+    if (rt_device_control(dev, RT_DEVICE_CTRL_WDT_START, RT_NULL) != RT_EOK) {
+        wdt->hw_dev = RT_NULL;
+        rt_kprintf("Hardware watchdog '%s' start failed\n", device_name);
+        return -RT_ERROR;
+    }
+
+    rt_kprintf("Hardware watchdog '%s' started, timeout %d s\n", device_name, timeout_s);
     return RT_EOK;
 }
 
+const soft_wdt_channel_t *soft_wdt_expired(soft_wdt_t *wdt)
+{
+    if (!wdt || wdt->expired < 0) return RT_NULL;
+
+    return &wdt->channels[wdt->expired];
+}
+
+void soft_wdt_dump(soft_wdt_t *wdt)
+{
+    rt_tick_t now = rt_tick_get();
+    rt_tick_t uptime;
+
+    if (!wdt) return;
+
+    rt_kprintf("%-12s %10s %10s %6s\n", "thread", "age(ms)", "limit(ms)", "missed");
+    for (int i = 0; i < wdt->channel_count; i++) {
+        soft_wdt_channel_t *ch = &wdt->channels[i];
+        rt_kprintf("%-12s %10d %10d %6d\n", ch->name,
+                   (now - ch->last_beat) * 1000 / RT_TICK_PER_SECOND,
+                   ch->deadline * 1000 / RT_TICK_PER_SECOND, ch->missed);
+    }
+    if (wdt->expired >= 0) {
+        rt_kprintf("Last expired: %s\n", wdt->channels[wdt->expired].name);
+    }
+
+    /* 唤醒频率（每分钟），原轮询线程固定为600次 */
+    uptime = now - wdt->start_tick;
+    rt_kprintf("Wakeups      : %d, %d/min, period %d ms\n", wdt->wakeups,
+               uptime ? (rt_uint32_t)((rt_uint64_t)wdt->wakeups * 60 * RT_TICK_PER_SECOND / uptime) : 0,
+               wdt->period * 1000 / RT_TICK_PER_SECOND);
+    if (wdt->hw_dev) {
+        rt_uint32_t timeout_s = 0;
+        rt_device_control(wdt->hw_dev, RT_DEVICE_CTRL_WDT_GET_TIMEOUT, &timeout_s);
+        rt_kprintf("HW watchdog  : timeout %d s, %d kicks, %d withheld\n",
+                   timeout_s, wdt->hw_kicks, wdt->hw_withheld);
+    }
+}
+
 /* 销毁软件看门狗 */
 rt_err_t soft_wdt_destroy(soft_wdt_t *wdt)
 {
     if (!wdt) return -RT_ERROR;
 
     soft_wdt_stop(wdt);
-    rt_timer_delete(wdt->timer);
-    rt_thread_delete(wdt->thread);
-
-    /* 修正：使用 rt_mutex_detach 并释放内存 */
-    rt_mutex_detach(wdt->mutex);
-    rt_free(wdt->mutex);
+    rt_timer_detach(wdt->timer);
 
-    rt_free(wdt);
+    /* 归还实例到静态池 */
+    mem_pool_free(&soft_wdt_pool, wdt);
 
     rt_kprintf("Software watchdog destroyed\n");
     return RT_EOK;
@@ -5,20 +5,56 @@
 #include <rtdevice.h>  // 添加缺少的头文件
 #include <rthw.h>
 
-/* 软件看门狗超时回调函数类型 */
+#ifndef SOFT_WDT_MAX_INSTANCES
+#define SOFT_WDT_MAX_INSTANCES  2
+#endif
+
+#ifndef SOFT_WDT_MAX_CHANNELS
+#define SOFT_WDT_MAX_CHANNELS   8
+#endif
+
+#define SOFT_WDT_MIN_PERIOD_MS      10      // 监督定时器最短唤醒间隔
+
+/* 软件看门狗超时回调函数类型。
+ * 在软件定时器线程中调用，可以打印，但不可长时间阻塞 */
 typedef void (*soft_wdt_callback_t)(void *arg);
 
+/* 心跳通道：每个受监控线程注册一个槽位，各自设定截止时间 */
+typedef struct {
+    const char *name;           // 线程名
+    rt_tick_t deadline;         // 允许的最长心跳间隔（tick）
+    volatile rt_tick_t last_beat; // 最近一次心跳时刻，喂狗仅为一次32位写入
+    rt_uint32_t missed;         // 累计超时次数
+    rt_bool_t late;             // 当前处于超时状态，恢复心跳后清除
+} soft_wdt_channel_t;
+
 /* 软件看门狗句柄类型 */
 typedef struct soft_wdt {
-    rt_thread_t thread;         // 看门狗线程句柄
-    rt_timer_t timer;           // 超时定时器
-    rt_mutex_t mutex;           // 互斥锁
-    rt_uint32_t timeout;        // 超时时间（毫秒）
-    volatile rt_uint32_t feed_count;     // 喂狗计数，添加volatile修饰符
-    rt_uint32_t reset_count;    // 复位阈值
+    rt_timer_t timer;           // 监督定时器，单次触发，按最近截止时间重新装载
+    rt_tick_t timeout;          // 超时时间（tick），未注册通道时按此检查喂狗，也是最长唤醒间隔
+    volatile rt_tick_t last_feed; // soft_wdt_feed最近一次喂狗时刻
     rt_bool_t enabled;          // 看门狗使能标志
     soft_wdt_callback_t callback; // 超时回调函数
     void *callback_arg;         // 回调函数参数
+
+    soft_wdt_channel_t channels[SOFT_WDT_MAX_CHANNELS];
+    volatile rt_uint8_t channel_count;  // 已注册通道数，槽位填好后才递增
+    rt_int8_t expired;          // 最近一次超时的通道，-1表示无
+
+    /* 硬件看门狗：全部通道正常时才由监督定时器喂狗 */
+    rt_device_t hw_dev;
+    rt_tick_t hw_interval;      // 硬件喂狗最长间隔，取硬件超时的一半
+    rt_uint32_t hw_kicks;       // 硬件喂狗次数
+    rt_uint32_t hw_withheld;    // 因通道超时而暂停喂狗的巡检次数
+
+    /* 开销统计 */
+    rt_uint32_t wakeups;        // 监督定时器唤醒次数
+    rt_tick_t period;           // 最近一次装载的唤醒间隔（tick）
+    rt_tick_t due;              // 下一次唤醒时刻
+    rt_tick_t start_tick;       // 启动时刻，用于计算平均唤醒频率
+
+    /* 内核对象静态存储，实例来自静态池，不使用堆 */
+    struct rt_timer timer_obj;
 } soft_wdt_t;
 
 /* 软件看门狗初始化 */
@@ -31,10 +67,34 @@ rt_err_t soft_wdt_start(soft_wdt_t *wdt);
 /* 停止软件看门狗 */
 rt_err_t soft_wdt_stop(soft_wdt_t *wdt);
 
-/* 喂狗操作 */
+/* 喂狗操作（未注册心跳通道时使用），单次原子写入 */
 rt_err_t soft_wdt_feed(soft_wdt_t *wdt);
 
+/* 注册心跳通道，返回通道号，失败返回负值 */
+int soft_wdt_register(soft_wdt_t *wdt, const char *name, rt_uint32_t deadline_ms);
+
+/* 通道心跳：单次原子写入，不加锁，可在任意线程调用 */
+rt_inline void soft_wdt_heartbeat(soft_wdt_t *wdt, int channel)
+{
+    if (wdt && (rt_uint32_t)channel < SOFT_WDT_MAX_CHANNELS) {
+        wdt->channels[channel].last_beat = rt_tick_get();
+    }
+}
+
+/* 接入硬件看门狗设备（如"wdt"），超时时间取软件看门狗的超时设置；
+ * 独立看门狗启动后无法停止，soft_wdt_stop后将由硬件复位 */
+rt_err_t soft_wdt_attach_hw(soft_wdt_t *wdt, const char *device_name);
+
+/* 最近一次超时的通道，无超时返回RT_NULL */
+const soft_wdt_channel_t *soft_wdt_expired(soft_wdt_t *wdt);
+
+/* 打印各通道心跳状态与监督开销 */
+void soft_wdt_dump(soft_wdt_t *wdt);
+
 /* 销毁软件看门狗 */
 rt_err_t soft_wdt_destroy(soft_wdt_t *wdt);
 
+/* 系统看门狗实例，由main.c创建，各模块注册自己的心跳通道 */
+extern soft_wdt_t *g_soft_wdt;
+
 #endif /* SOFT_WDT_H */
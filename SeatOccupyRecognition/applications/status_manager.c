@@ -6,12 +6,15 @@
 /* 头文件已定义MAX_SEATS，此处无需重复定义 */
 
 struct seat_manager_type seat_manager;
+static struct rt_mutex seat_manager_mutex;
 
 void status_init(void)
 {
-    /* 初始化互斥锁 */
-    seat_manager.lock = rt_mutex_create("seat_mux", RT_IPC_FLAG_PRIO);
-    RT_ASSERT(seat_manager.lock != RT_NULL);
+    /* 初始化互斥锁（静态对象，不占用堆，重复初始化时跳过） */
+    if (seat_manager.lock == RT_NULL) {
+        rt_mutex_init(&seat_manager_mutex, "seat_mux", RT_IPC_FLAG_PRIO);
+        seat_manager.lock = &seat_manager_mutex;
+    }
 
     /* 初始化所有座位状态为空闲 */
     for (int i = 0; i < MAX_SEATS; i++) {
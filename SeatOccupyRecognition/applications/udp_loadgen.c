@@ -0,0 +1,287 @@
+#include <rtthread.h>
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "udp_loadgen.h"
+#include "seat_ingest.h"
+#include "seat_db.h"
+
+#define DBG_TAG "loadgen"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+/* 与接收缓冲区一致，超出的记录不再追加 */
+#define LOADGEN_DATAGRAM_MAX    384
+
+/* 第k次突发的计划时刻：start + k * burst / rate 秒，用64位运算避免累积误差 */
+static rt_tick_t loadgen_due(const udp_loadgen_t *gen, const udp_loadgen_board_t *b)
+{
+    rt_uint64_t offset = (rt_uint64_t)b->bursts * gen->cfg.burst * RT_TICK_PER_SECOND / gen->cfg.rate;
+    return b->start + (rt_tick_t)offset;
+}
+
+static rt_uint32_t loadgen_rand(udp_loadgen_t *gen)
+{
+    gen->rand = gen->rand * 1103515245 + 12345;
+    return gen->rand >> 16;
+}
+
+static rt_size_t loadgen_format(udp_loadgen_t *gen, udp_loadgen_board_t *b, char *buf)
+{
+    rt_size_t len = rt_snprintf(buf, LOADGEN_DATAGRAM_MAX, "#%d;", b->seq++);
+
+    for (rt_uint16_t i = 0; i < gen->cfg.records; i++) {
+        rt_uint16_t seat = b->first_seat + loadgen_rand(gen) % gen->seats_per_board;
+        int n = rt_snprintf(buf + len, LOADGEN_DATAGRAM_MAX - len, i ? ";A%02d:%d" : "A%02d:%d",
+                            seat, (int)(loadgen_rand(gen) % SEAT_STATUS_NUM));
+        if (n <= 0 || len + n >= LOADGEN_DATAGRAM_MAX) {
+            break;
+        }
+        len += n;
+    }
+    return len;
+}
+
+static void loadgen_send_burst(udp_loadgen_t *gen, udp_loadgen_board_t *b)
+{
+    struct sockaddr_in dest;
+    char buf[LOADGEN_DATAGRAM_MAX];
+
+    rt_memset(&dest, 0, sizeof(dest));
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(gen->cfg.dest_port);
+    dest.sin_addr.s_addr = gen->cfg.dest_addr;
+
+    for (rt_uint16_t i = 0; i < gen->cfg.burst; i++) {
+        rt_size_t len = loadgen_format(gen, b, buf);
+
+        if (sendto(b->sock, buf, len, 0, (struct sockaddr *)&dest, sizeof(dest)) == (int)len) {
+            b->sent++;
+        } else {
+            b->send_errors++;
+        }
+    }
+    b->bursts++;
+}
+
+rt_err_t udp_loadgen_setup(udp_loadgen_t *gen, const udp_loadgen_config_t *cfg)
+{
+    rt_tick_t interval;
+
+    if (cfg->boards == 0 || cfg->boards > SEAT_LOADGEN_MAX_BOARDS ||
+        cfg->rate == 0 || cfg->burst == 0 || cfg->records == 0) {
+        return -RT_EINVAL;
+    }
+
+    rt_memset(gen, 0, sizeof(*gen));
+    gen->cfg = *cfg;
+    gen->rand = 0x5EA7;
+    /* 各板负责互不重叠的座位区间，数据库容量按板数平分 */
+    gen->seats_per_board = SEAT_DB_MAX_SEATS / cfg->boards;
+    if (gen->seats_per_board == 0) {
+        gen->seats_per_board = 1;
+    }
+
+    for (rt_uint16_t i = 0; i < cfg->boards; i++) {
+        udp_loadgen_board_t *b = &gen->board[i];
+        struct sockaddr_in local;
+        socklen_t local_len = sizeof(local);
+
+        b->sock = socket(AF_INET, SOCK_DGRAM, 0);
+        if (b->sock < 0) {
+            LOG_E("Board %d socket failed", i);
+            gen->cfg.boards = i;
+            udp_loadgen_close(gen);
+            return -RT_ENOMEM;
+        }
+
+        /* 绑定临时端口，接收端据此区分各板 */
+        rt_memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = INADDR_ANY;
+        local.sin_port = 0;
+        if (bind(b->sock, (struct sockaddr *)&local, sizeof(local)) < 0 ||
+            getsockname(b->sock, (struct sockaddr *)&local, &local_len) < 0) {
+            LOG_E("Board %d bind failed", i);
+            gen->cfg.boards = i + 1;
+            udp_loadgen_close(gen);
+            return -RT_ERROR;
+        }
+        b->port = ntohs(local.sin_port);
+        b->first_seat = 1 + (i * gen->seats_per_board) % SEAT_DB_MAX_SEATS;
+    }
+
+    /* 起始时刻在一个突发周期内均匀错开 */
+    gen->start_tick = rt_tick_get();
+    interval = (rt_tick_t)((rt_uint64_t)cfg->burst * RT_TICK_PER_SECOND / cfg->rate);
+    for (rt_uint16_t i = 0; i < cfg->boards; i++) {
+        gen->board[i].start = gen->start_tick + interval * i / cfg->boards;
+    }
+    return RT_EOK;
+}
+
+rt_int32_t udp_loadgen_poll(udp_loadgen_t *gen)
+{
+    rt_tick_t now = rt_tick_get();
+    rt_int32_t wait = RT_TICK_PER_SECOND;
+
+    for (rt_uint16_t i = 0; i < gen->cfg.boards; i++) {
+        udp_loadgen_board_t *b = &gen->board[i];
+        rt_int32_t delta = (rt_int32_t)(loadgen_due(gen, b) - now);
+
+        /* 落后时每次只补发一个突发，给接收端留出处理机会 */
+        if (delta <= 0) {
+            loadgen_send_burst(gen, b);
+            delta = (rt_int32_t)(loadgen_due(gen, b) - now);
+        }
+        if (delta < wait) {
+            wait = delta > 0 ? delta : 0;
+        }
+    }
+    return wait;
+}
+
+void udp_loadgen_close(udp_loadgen_t *gen)
+{
+    for (rt_uint16_t i = 0; i < gen->cfg.boards; i++) {
+        if (gen->board[i].sock >= 0) {
+            close(gen->board[i].sock);
+            gen->board[i].sock = -1;
+        }
+    }
+    gen->stop_tick = rt_tick_get();
+}
+
+/* 按源端口查找接收端统计：经lwIP回环时源地址可能是本机接口地址，不比较地址 */
+static const seat_ingest_source_t *loadgen_find_source(rt_uint16_t port)
+{
+    const seat_ingest_source_t *src;
+
+    for (rt_uint16_t i = 0; (src = seat_ingest_get_source(i)) != RT_NULL; i++) {
+        if (src->port == port) {
+            return src;
+        }
+    }
+    return RT_NULL;
+}
+
+void udp_loadgen_report(const udp_loadgen_t *gen)
+{
+    rt_tick_t end = gen->stop_tick ? gen->stop_tick : rt_tick_get();
+    rt_uint32_t elapsed_ms = (end - gen->start_tick) * 1000 / RT_TICK_PER_SECOND;
+    rt_uint32_t sent = 0, errors = 0, received = 0;
+
+    if (gen->cfg.boards == 0) {
+        rt_kprintf("Load generator not started\n");
+        return;
+    }
+    if (elapsed_ms == 0) {
+        elapsed_ms = 1;
+    }
+
+    rt_kprintf("%-5s %5s %9s %6s %9s %7s\n", "board", "port", "sent", "err", "received", "lost");
+    for (rt_uint16_t i = 0; i < gen->cfg.boards; i++) {
+        const udp_loadgen_board_t *b = &gen->board[i];
+        const seat_ingest_source_t *src = loadgen_find_source(b->port);
+        rt_uint32_t rx = src ? src->datagrams : 0;
+
+        rt_kprintf("%-5d %5d %9d %6d %9d %7d\n", i, b->port, b->sent, b->send_errors,
+                   rx, b->sent > rx ? b->sent - rx : 0);
+        sent += b->sent;
+        errors += b->send_errors;
+        received += rx;
+    }
+
+    rt_kprintf("Elapsed  : %d ms\n", elapsed_ms);
+    rt_kprintf("Offered  : %d datagram/s (%d boards x %d/s, burst %d, %d records)\n",
+               gen->cfg.boards * gen->cfg.rate, gen->cfg.boards, gen->cfg.rate,
+               gen->cfg.burst, gen->cfg.records);
+    rt_kprintf("Achieved : %d datagram/s sent, %d datagram/s received\n",
+               (rt_uint32_t)((rt_uint64_t)sent * 1000 / elapsed_ms),
+               (rt_uint32_t)((rt_uint64_t)received * 1000 / elapsed_ms));
+    rt_kprintf("Lost     : %d of %d (send errors %d)\n",
+               sent > received ? sent - received : 0, sent, errors);
+}
+
+#if defined(RT_USING_FINSH) && defined(RT_USING_SAL)
+
+/* 目标板上由独立线程发送，优先级低于接收线程，数据报到达时接收端可立即抢占 */
+static udp_loadgen_t loadgen;
+static volatile rt_bool_t loadgen_running = RT_FALSE;
+static volatile rt_bool_t loadgen_busy = RT_FALSE;  // 线程仍在上一次运行中（含停止后的关闭与报告）
+static rt_bool_t loadgen_started = RT_FALSE;
+static struct rt_semaphore loadgen_sem;
+
+static struct rt_thread loadgen_thread;
+ALIGN(RT_ALIGN_SIZE) static rt_uint8_t loadgen_thread_stack[1536];
+
+static void loadgen_thread_entry(void *param)
+{
+    while (1) {
+        rt_sem_take(&loadgen_sem, RT_WAITING_FOREVER);
+
+        loadgen_busy = RT_TRUE;
+        while (loadgen_running) {
+            rt_int32_t wait = udp_loadgen_poll(&loadgen);
+            rt_thread_delay(wait > 0 ? wait : 1);
+        }
+        udp_loadgen_close(&loadgen);
+        udp_loadgen_report(&loadgen);
+        loadgen_busy = RT_FALSE;
+    }
+}
+
+static void udp_load(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "start") == 0) {
+        udp_loadgen_config_t cfg;
+
+        if (loadgen_running || loadgen_busy) {
+            rt_kprintf("Load generator already running\n");
+            return;
+        }
+        cfg.boards = argc > 2 ? atoi(argv[2]) : 4;
+        cfg.rate = argc > 3 ? atoi(argv[3]) : 10;
+        cfg.burst = argc > 4 ? atoi(argv[4]) : 1;
+        cfg.records = argc > 5 ? atoi(argv[5]) : 1;
+        cfg.dest_port = SEAT_INGEST_PORT;
+        cfg.dest_addr = htonl(INADDR_LOOPBACK);
+
+        if (!loadgen_started) {
+            rt_sem_init(&loadgen_sem, "loadgen", 0, RT_IPC_FLAG_PRIO);
+            if (rt_thread_init(&loadgen_thread, "udp_load", loadgen_thread_entry, RT_NULL,
+                               loadgen_thread_stack, sizeof(loadgen_thread_stack),
+                               RT_THREAD_PRIORITY_MAX / 2 + 1, 10) != RT_EOK) {
+                rt_kprintf("Load generator thread init failed\n");
+                return;
+            }
+            rt_thread_startup(&loadgen_thread);
+            loadgen_started = RT_TRUE;
+        }
+
+        seat_ingest_reset_stats();
+        if (udp_loadgen_setup(&loadgen, &cfg) != RT_EOK) {
+            rt_kprintf("Invalid load configuration or out of sockets\n");
+            return;
+        }
+        loadgen_running = RT_TRUE;
+        rt_sem_release(&loadgen_sem);
+    } else if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        /* 发送线程在下一次轮询后关闭套接字并打印报告 */
+        loadgen_running = RT_FALSE;
+    } else if (argc > 1 && strcmp(argv[1], "stat") == 0) {
+        udp_loadgen_report(&loadgen);
+    } else {
+        rt_kprintf("Usage: udp_load start [boards] [rate] [burst] [records] | stop | stat\n");
+        rt_kprintf("Sends to 127.0.0.1:%d, requires WiFi connected (receiver socket open)\n",
+                   SEAT_INGEST_PORT);
+    }
+}
+MSH_CMD_EXPORT(udp_load, UDP load generator: udp_load start [boards] [rate] [burst] [records] | stop | stat);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __UDP_LOADGEN_H__
+#define __UDP_LOADGEN_H__
+
+#include <rtthread.h>
+
+/* UDP负载发生器：模拟多块识别板向接收端口发送带序号的真实数据报，
+ * 目标板上经lwIP回环接口发送，主机上经127.0.0.1发送（见tools/ingest_bench） */
+
+#ifndef SEAT_LOADGEN_MAX_BOARDS
+#define SEAT_LOADGEN_MAX_BOARDS     8
+#endif
+
+typedef struct {
+    rt_uint16_t boards;         // 模拟的识别板数量
+    rt_uint16_t burst;          // 每次突发连续发送的数据报数，平均速率不变
+    rt_uint32_t rate;           // 每块板每秒数据报数
+    rt_uint16_t records;        // 每个数据报的座位记录数，1为单记录格式
+    rt_uint16_t dest_port;
+    rt_uint32_t dest_addr;      // IPv4地址（网络字节序）
+} udp_loadgen_config_t;
+
+typedef struct {
+    int sock;
+    rt_uint16_t port;           // 本地源端口，接收端按此区分各板
+    rt_uint16_t first_seat;     // 本板负责的座位区间起点
+    rt_uint32_t seq;
+    rt_uint32_t bursts;         // 已发出的突发次数
+    rt_uint32_t sent;
+    rt_uint32_t send_errors;
+    rt_tick_t start;            // 各板起始时刻错开，避免同时突发
+} udp_loadgen_board_t;
+
+typedef struct {
+    udp_loadgen_config_t cfg;
+    udp_loadgen_board_t board[SEAT_LOADGEN_MAX_BOARDS];
+    rt_uint16_t seats_per_board;
+    rt_uint32_t rand;
+    rt_tick_t start_tick;
+    rt_tick_t stop_tick;        // 0表示仍在运行
+} udp_loadgen_t;
+
+/* 按配置打开各板套接字，成功后从当前时刻开始计时 */
+rt_err_t udp_loadgen_setup(udp_loadgen_t *gen, const udp_loadgen_config_t *cfg);
+/* 发送所有已到期的突发（每板每次最多一个），返回距下一次到期的滴答数，落后时返回0 */
+rt_int32_t udp_loadgen_poll(udp_loadgen_t *gen);
+void udp_loadgen_close(udp_loadgen_t *gen);
+/* 打印计划速率与实际速率，并按源端口对照接收端统计给出丢包 */
+void udp_loadgen_report(const udp_loadgen_t *gen);
+
+#endif
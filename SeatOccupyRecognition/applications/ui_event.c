@@ -0,0 +1,31 @@
+#include <rtthread.h>
+
+#include "ui_event.h"
+
+static struct rt_event ui_event;
+static rt_bool_t ui_event_ready = RT_FALSE;
+
+void ui_event_init(void)
+{
+    rt_event_init(&ui_event, "ui_evt", RT_IPC_FLAG_FIFO);
+    ui_event_ready = RT_TRUE;
+}
+
+void ui_event_post(rt_uint32_t events)
+{
+    if (ui_event_ready) {
+        rt_event_send(&ui_event, events);
+    }
+}
+
+rt_uint32_t ui_event_wait(rt_int32_t timeout_ms)
+{
+    rt_uint32_t recved = 0;
+
+    if (rt_event_recv(&ui_event, UI_EVT_ALL,
+                      RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                      rt_tick_from_millisecond(timeout_ms), &recved) != RT_EOK) {
+        return 0;
+    }
+    return recved;
+}
@@ -0,0 +1,25 @@
+#ifndef __UI_EVENT_H__
+#define __UI_EVENT_H__
+
+#include <rtthread.h>
+
+/* UI线程唤醒事件 */
+#define UI_EVT_SEAT_CHANGED     (1UL << 0)  // 数据库座位状态变化
+#define UI_EVT_SEAT_SELECTED    (1UL << 1)  // 待显示的座位更新
+#define UI_EVT_WIFI_UP          (1UL << 2)  // 网络连接就绪
+#define UI_EVT_WIFI_DOWN        (1UL << 3)  // 网络断开
+#define UI_EVT_PAGE_NEXT        (1UL << 4)  // 分页视图翻页请求
+#define UI_EVT_ALL              (UI_EVT_SEAT_CHANGED | UI_EVT_SEAT_SELECTED | \
+                                 UI_EVT_WIFI_UP | UI_EVT_WIFI_DOWN | UI_EVT_PAGE_NEXT)
+
+/* 无事件时的最长刷新间隔 */
+#ifndef UI_MAX_REFRESH_MS
+#define UI_MAX_REFRESH_MS       1000
+#endif
+
+void ui_event_init(void);
+void ui_event_post(rt_uint32_t events);
+/* 等待任一事件，超时返回0 */
+rt_uint32_t ui_event_wait(rt_int32_t timeout_ms);
+
+#endif
@@ -0,0 +1,165 @@
+#include <rtthread.h>
+#include <stdlib.h>
+#include <finsh.h>
+#include <drv_lcd.h>
+
+#include "ui_grid.h"
+#include "seat_db.h"
+#include "lcd_colors.h"
+#include "lcd_tile.h"
+#include "ui_perf.h"
+
+static rt_uint16_t grid_origin = 1;
+static volatile rt_bool_t grid_full_redraw = RT_TRUE;
+static ui_grid_stats_t grid_stats;
+
+void ui_grid_set_origin(rt_uint16_t first_id)
+{
+    grid_origin = first_id;
+    grid_full_redraw = RT_TRUE;
+}
+
+void ui_grid_invalidate(void)
+{
+    grid_full_redraw = RT_TRUE;
+}
+
+/* 未入库的座位显示为灰色 */
+static rt_uint16_t cell_color(rt_uint8_t status, rt_uint8_t flags)
+{
+    if (status >= SEAT_STATUS_NUM) {
+        return GRAY;
+    }
+    if (flags & SEAT_FLAG_CLAIM_EXPIRED) {
+        return ORANGE;
+    }
+    return seat_status_colors[status];
+}
+
+#define CELL_X(index)   (((index) % UI_GRID_COLS) * UI_GRID_CELL_W)
+#define CELL_Y(index)   (UI_GRID_TOP + ((index) / UI_GRID_COLS) * UI_GRID_CELL_H)
+#define CELL_W          (UI_GRID_CELL_W - UI_GRID_GAP)
+#define CELL_H          (UI_GRID_CELL_H - UI_GRID_GAP)
+
+/* 格子底色经瓦片缓冲区异步传输，返回推送的像素数 */
+static rt_uint32_t draw_cell_fill(rt_uint16_t index, rt_uint16_t color)
+{
+    lcd_tile_fill_rect(CELL_X(index), CELL_Y(index), CELL_W, CELL_H, color);
+    return (rt_uint32_t)CELL_W * CELL_H;
+}
+
+/* 座位号文字仍由驱动直接绘制，须在瓦片传输同步之后调用 */
+static rt_uint32_t draw_cell_label(rt_uint16_t index, rt_uint16_t seat_id, rt_uint16_t color)
+{
+    char label[8];
+    rt_uint32_t len;
+    rt_uint32_t t = ui_perf_stamp();
+
+    len = rt_snprintf(label, sizeof(label), "%d", seat_id);
+    ui_perf_add(UI_PERF_LAYOUT, t);
+
+    t = ui_perf_stamp();
+    lcd_set_color(BLACK, color);
+    lcd_show_string(CELL_X(index) + (CELL_W - len * (UI_GRID_FONT / 2)) / 2,
+                    CELL_Y(index) + (CELL_H - UI_GRID_FONT) / 2, UI_GRID_FONT, label);
+    ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+    return len * (UI_GRID_FONT / 2) * UI_GRID_FONT;
+}
+
+void ui_grid_refresh(void)
+{
+    rt_uint16_t ids[UI_GRID_CELLS];
+    rt_uint8_t status[UI_GRID_CELLS];
+    rt_uint8_t flags[UI_GRID_CELLS];
+    rt_uint16_t colors[UI_GRID_CELLS];
+    rt_uint32_t dirty[SEAT_BITMAP_WORDS(SEAT_ID_LIMIT)] = {0};
+    rt_uint16_t begin = grid_origin;
+    rt_uint16_t end = grid_origin + UI_GRID_CELLS;
+    rt_uint32_t n, pixels = 0;
+    rt_bool_t full = grid_full_redraw;
+    rt_uint32_t t;
+
+    if (end > SEAT_ID_LIMIT) {
+        end = SEAT_ID_LIMIT;
+    }
+
+    /* 持锁期间只取脏位和状态快照，绘制在锁外进行 */
+    t = ui_perf_stamp();
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    db_take_dirty(dirty);
+    if (full) {
+        n = 0;
+        for (rt_uint16_t id = begin; id < end; id++) {
+            ids[n++] = id;
+        }
+    } else {
+        n = seat_bitmap_find_first_n(dirty, begin, end, ids, UI_GRID_CELLS);
+    }
+    for (rt_uint32_t i = 0; i < n; i++) {
+        SeatInfo *seat = db_get_seat(ids[i]);
+        status[i] = seat ? seat->status : SEAT_STATUS_NUM;
+        flags[i] = seat ? seat->flags : 0;
+    }
+    rt_mutex_release(seat_db.lock);
+    ui_perf_add(UI_PERF_DB_READ, t);
+
+    grid_full_redraw = RT_FALSE;
+    grid_stats.refreshes++;
+
+    t = ui_perf_stamp();
+    if (full) {
+        lcd_tile_fill_rect(0, 0, 240, 240, WHITE);
+        pixels += 240 * 240;
+        grid_stats.full_redraws++;
+    }
+
+    /* 先提交全部底色，CPU合成下一块时上一块在传输；再统一同步后绘制文字 */
+    for (rt_uint32_t i = 0; i < n; i++) {
+        colors[i] = cell_color(status[i], flags[i]);
+        pixels += draw_cell_fill(ids[i] - begin, colors[i]);
+    }
+    lcd_tile_sync();
+    ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+    if (full) {
+        char title[32];
+        t = ui_perf_stamp();
+        rt_snprintf(title, sizeof(title), "Seats %d-%d", begin, end - 1);
+        ui_perf_add(UI_PERF_LAYOUT, t);
+        t = ui_perf_stamp();
+        lcd_set_color(BLACK, WHITE);
+        lcd_show_string(10, 4, 24, title);
+        ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+        pixels += rt_strlen(title) * 12 * 24;
+    }
+    for (rt_uint32_t i = 0; i < n; i++) {
+        pixels += draw_cell_label(ids[i] - begin, ids[i], colors[i]);
+    }
+
+    grid_stats.cells_drawn += n;
+    grid_stats.pixels_last = pixels;
+    grid_stats.pixels_total += pixels;
+    if (pixels > grid_stats.pixels_max) {
+        grid_stats.pixels_max = pixels;
+    }
+}
+
+void ui_grid_get_stats(ui_grid_stats_t *stats)
+{
+    *stats = grid_stats;
+}
+
+static void ui_grid_stat(int argc, char **argv)
+{
+    rt_kprintf("Grid origin      : %d (%d cells)\n", grid_origin, UI_GRID_CELLS);
+    rt_kprintf("Refreshes        : %d\n", grid_stats.refreshes);
+    rt_kprintf("Full redraws     : %d\n", grid_stats.full_redraws);
+    rt_kprintf("Cells drawn      : %d\n", grid_stats.cells_drawn);
+    rt_kprintf("Pixels total     : %d\n", grid_stats.pixels_total);
+    rt_kprintf("Pixels last/max  : %d / %d\n", grid_stats.pixels_last, grid_stats.pixels_max);
+    if (grid_stats.refreshes) {
+        rt_kprintf("Pixels per update: %d\n", grid_stats.pixels_total / grid_stats.refreshes);
+    }
+}
+MSH_CMD_EXPORT(ui_grid_stat, show grid dashboard render statistics);
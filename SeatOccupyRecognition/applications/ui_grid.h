@@ -0,0 +1,32 @@
+#ifndef __UI_GRID_H__
+#define __UI_GRID_H__
+
+#include <rtthread.h>
+
+/* 多座位网格视图：240像素宽，每格一个座位，仅重绘状态变化的格子 */
+#define UI_GRID_COLS        8
+#define UI_GRID_ROWS        8
+#define UI_GRID_CELLS       (UI_GRID_COLS * UI_GRID_ROWS)
+#define UI_GRID_TOP         32                                  // 标题栏高度
+#define UI_GRID_CELL_W      (240 / UI_GRID_COLS)
+#define UI_GRID_CELL_H      ((240 - UI_GRID_TOP) / UI_GRID_ROWS)
+#define UI_GRID_GAP         2                                   // 格子间隙
+#define UI_GRID_FONT        16
+
+typedef struct {
+    rt_uint32_t refreshes;      // 刷新次数（含无变化）
+    rt_uint32_t full_redraws;   // 整屏重绘次数
+    rt_uint32_t cells_drawn;    // 累计重绘格子数
+    rt_uint32_t pixels_total;   // 累计推送像素数
+    rt_uint32_t pixels_last;    // 最近一次刷新推送像素数
+    rt_uint32_t pixels_max;     // 单次刷新最大像素数
+} ui_grid_stats_t;
+
+/* 设置网格显示的首个座位ID，并触发整屏重绘 */
+void ui_grid_set_origin(rt_uint16_t first_id);
+void ui_grid_invalidate(void);
+/* 由UI线程调用，取走数据库脏位并重绘变化的格子 */
+void ui_grid_refresh(void);
+void ui_grid_get_stats(ui_grid_stats_t *stats);
+
+#endif
@@ -0,0 +1,383 @@
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <string.h>
+#include <finsh.h>
+#include <drv_lcd.h>
+
+#include "ui_pager.h"
+#include "ui_event.h"
+#include "lcd_colors.h"
+#include "lcd_tile.h"
+#include "label_cache.h"
+#include "ui_perf.h"
+
+#define DBG_TAG "ui.page"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+#define PAGE_TOP        32                          // 标题栏高度
+#define PAGE_LEFT       32                          // 行标签宽度
+#define PAGE_GAP        2
+#define CELL_W          ((240 - PAGE_LEFT) / UI_PAGE_COLS)
+#define CELL_H          ((240 - PAGE_TOP) / UI_PAGE_ROWS)
+#define CELL_X(i)       (PAGE_LEFT + ((i) % UI_PAGE_COLS) * CELL_W)
+#define CELL_Y(i)       (PAGE_TOP + ((i) / UI_PAGE_COLS) * CELL_H)
+#define LABEL_SIZE      16
+#define CLEAR_ROWS      48                          // 整屏清除时每片清除的行数
+
+#define LAYOUT_TEXT     32                          // 标题与行标签文字缓冲，含结尾0
+#define LABEL_BYTES(n)  ((((n) * (LABEL_SIZE / 2) + 7) / 8) * LABEL_SIZE)
+#define LAYOUT_BYTES    (LABEL_BYTES(LAYOUT_TEXT - 1) + UI_PAGE_ROWS * LABEL_BYTES(5))
+
+/* 每页的静态内容：标题与行首座位号。只为当前页和下一页光栅化，两个槽位轮换使用 */
+typedef struct {
+    rt_int32_t zone;                // 已光栅化的分区，-1为空
+    rt_uint8_t *bits;               // 启动时从标签缓存区划出的LAYOUT_BYTES字节
+    lcd_label_t title;
+    lcd_label_t rows[UI_PAGE_ROWS];
+} page_layout_t;
+
+static page_layout_t layouts[2];
+
+/* 屏上各格当前颜色，翻页时只重绘颜色不同的格子 */
+static rt_uint16_t shown_color[SEAT_ZONE_SIZE];
+static rt_uint32_t shown_valid[SEAT_BITMAP_WORDS(SEAT_ZONE_SIZE)];
+
+static rt_uint16_t page;
+static volatile rt_int32_t page_request = -1;       // 待切换的目标页
+static volatile rt_uint16_t clear_row = 0;          // 整屏清除进度，240表示已完成
+static rt_bool_t layout_pending = RT_TRUE;          // 需绘制标题与行标签
+static rt_bool_t strips_dirty = RT_FALSE;           // 标题栏与行标签区残留上一页内容
+static rt_uint32_t zone_seen[SEAT_ZONE_COUNT];      // 各分区已观察到的代数
+static rt_uint16_t cell_cursor = SEAT_ZONE_SIZE;    // 当前扫描位置，等于SEAT_ZONE_SIZE表示空闲
+static rt_uint32_t flip_pixels;
+static rt_tick_t last_flip;
+static rt_tick_t last_key;
+static ui_pager_stats_t pager_stats;
+
+static rt_uint16_t zone_cells(rt_uint16_t zone)
+{
+    rt_uint32_t first = (rt_uint32_t)zone * SEAT_ZONE_SIZE;
+    return first + SEAT_ZONE_SIZE <= SEAT_ID_LIMIT ? SEAT_ZONE_SIZE : SEAT_ID_LIMIT - first;
+}
+
+/* 分区占用的行数，末页不足一个分区时少于UI_PAGE_ROWS */
+static rt_uint16_t zone_rows(rt_uint16_t zone)
+{
+    return (zone_cells(zone) + UI_PAGE_COLS - 1) / UI_PAGE_COLS;
+}
+
+/* 按键中断：200ms内的抖动忽略 */
+static void page_key_irq(void *args)
+{
+    if (rt_tick_get() - last_key >= rt_tick_from_millisecond(200)) {
+        last_key = rt_tick_get();
+        ui_pager_next();
+    }
+}
+
+/* 标签文字：row为-1时是分区标题，否则是该行首个座位号 */
+static void layout_text(rt_uint16_t zone, rt_int32_t row, char *text)
+{
+    rt_uint16_t first = zone * SEAT_ZONE_SIZE;
+
+    if (row < 0) {
+        rt_snprintf(text, LAYOUT_TEXT, "Zone %d: %d-%d", zone, first, first + zone_cells(zone) - 1);
+    } else {
+        rt_snprintf(text, LAYOUT_TEXT, "%d", first + row * UI_PAGE_COLS);
+    }
+}
+
+/* 取分区的标签，未缓存时在不属于当前页的槽位中光栅化 */
+static const page_layout_t *layout_prepare(rt_uint16_t zone)
+{
+    page_layout_t *layout;
+    rt_uint8_t *bits;
+    rt_size_t left = LAYOUT_BYTES;
+    char text[LAYOUT_TEXT];
+
+    for (rt_uint32_t i = 0; i < RT_ARRAY_SIZE(layouts); i++) {
+        if (layouts[i].zone == zone) {
+            return &layouts[i];
+        }
+    }
+
+    layout = layouts[0].zone == page ? &layouts[1] : &layouts[0];
+    layout->zone = zone;
+    bits = layout->bits;
+    if (bits == RT_NULL) {
+        return layout;          // 没有缓冲区，标签全部由字库直接绘制
+    }
+
+    layout_text(zone, -1, text);
+    if (label_cache_render(&layout->title, bits, left, text, LABEL_SIZE) == RT_EOK) {
+        bits += layout->title.stride * layout->title.h;
+        left -= layout->title.stride * layout->title.h;
+    }
+    for (rt_uint16_t row = 0; row < UI_PAGE_ROWS; row++) {
+        lcd_label_t *label = &layout->rows[row];
+
+        layout_text(zone, row, text);
+        if (label_cache_render(label, bits, left, text, LABEL_SIZE) == RT_EOK) {
+            bits += label->stride * label->h;
+            left -= label->stride * label->h;
+        }
+    }
+    return layout;
+}
+
+rt_err_t ui_pager_init(void)
+{
+    rt_err_t ret = RT_EOK;
+
+    for (rt_uint32_t i = 0; i < RT_ARRAY_SIZE(layouts); i++) {
+        layouts[i].zone = -1;
+        layouts[i].bits = label_cache_reserve(LAYOUT_BYTES);
+        if (layouts[i].bits == RT_NULL) {
+            ret = -RT_ENOMEM;
+        }
+    }
+
+    rt_pin_mode(SEAT_UI_PAGE_KEY_PIN, PIN_MODE_INPUT_PULLUP);
+    rt_pin_attach_irq(SEAT_UI_PAGE_KEY_PIN, PIN_IRQ_MODE_FALLING, page_key_irq, RT_NULL);
+    rt_pin_irq_enable(SEAT_UI_PAGE_KEY_PIN, PIN_IRQ_ENABLE);
+
+    last_flip = rt_tick_get();
+    return ret;
+}
+
+void ui_pager_invalidate(void)
+{
+    rt_memset(shown_valid, 0, sizeof(shown_valid));
+    clear_row = 0;
+}
+
+void ui_pager_goto(rt_uint16_t zone)
+{
+    page_request = zone % SEAT_ZONE_COUNT;
+    ui_event_post(UI_EVT_PAGE_NEXT);
+}
+
+void ui_pager_next(void)
+{
+    ui_pager_goto(page + 1);
+}
+
+static rt_uint16_t cell_color(rt_uint8_t status, rt_uint8_t flags)
+{
+    if (status >= SEAT_STATUS_NUM) {
+        return GRAY;
+    }
+    if (flags & SEAT_FLAG_CLAIM_EXPIRED) {
+        return ORANGE;
+    }
+    return seat_status_colors[status];
+}
+
+/* 绘制预光栅化标签，未缓存时退回驱动逐字绘制 */
+static rt_uint32_t draw_label(const lcd_label_t *label, rt_int32_t row, rt_uint16_t x, rt_uint16_t y)
+{
+    char text[LAYOUT_TEXT];
+
+    if (label->bits) {
+        return label_cache_draw(label, x, y, BLACK, WHITE);
+    }
+    layout_text(page, row, text);
+    lcd_tile_sync();
+    lcd_set_color(BLACK, WHITE);
+    lcd_show_string(x, y, LABEL_SIZE, text);
+    return rt_strlen(text) * (LABEL_SIZE / 2) * LABEL_SIZE;
+}
+
+/* 末页不足一个分区：上一页留在本页范围之外的格子涂成背景，并作废其颜色记录 */
+static rt_uint32_t clear_cells_tail(void)
+{
+    rt_uint32_t pixels = 0;
+
+    for (rt_uint16_t cell = zone_cells(page); cell < SEAT_ZONE_SIZE; cell++) {
+        if (!seat_bitmap_test(shown_valid, cell)) {
+            continue;
+        }
+        lcd_tile_fill_rect(CELL_X(cell), CELL_Y(cell), CELL_W - PAGE_GAP, CELL_H - PAGE_GAP, WHITE);
+        pixels += (CELL_W - PAGE_GAP) * (CELL_H - PAGE_GAP);
+        seat_bitmap_clear(shown_valid, cell);
+    }
+    return pixels;
+}
+
+/* 标题与行标签（同一页内不变），翻页时一次性绘制 */
+static rt_uint32_t draw_layout(void)
+{
+    const page_layout_t *layout = layout_prepare(page);
+    rt_uint32_t pixels = 0;
+
+    if (strips_dirty) {
+        lcd_tile_fill_rect(0, 0, 240, PAGE_TOP, WHITE);
+        lcd_tile_fill_rect(0, PAGE_TOP, PAGE_LEFT, 240 - PAGE_TOP, WHITE);
+        pixels += 240 * PAGE_TOP + PAGE_LEFT * (240 - PAGE_TOP);
+        strips_dirty = RT_FALSE;
+    }
+
+    pixels += draw_label(&layout->title, -1, 4, (PAGE_TOP - LABEL_SIZE) / 2);
+    for (rt_uint16_t row = 0; row < zone_rows(page); row++) {
+        pixels += draw_label(&layout->rows[row], row, 2,
+                             CELL_Y(row * UI_PAGE_COLS) + (CELL_H - LABEL_SIZE) / 2);
+    }
+    pixels += clear_cells_tail();
+    return pixels;
+}
+
+/* 扫描一片格子：持锁取状态快照，锁外只重绘颜色变化的格子 */
+static rt_uint32_t draw_cells_slice(void)
+{
+    rt_uint8_t status[SEAT_UI_PAGE_CELLS_PER_STEP];
+    rt_uint8_t flags[SEAT_UI_PAGE_CELLS_PER_STEP];
+    rt_uint16_t first = page * SEAT_ZONE_SIZE + cell_cursor;
+    rt_uint16_t end = zone_cells(page);
+    rt_uint16_t n = end - cell_cursor;
+    rt_uint32_t pixels = 0;
+    rt_uint32_t t;
+
+    if (n > SEAT_UI_PAGE_CELLS_PER_STEP) {
+        n = SEAT_UI_PAGE_CELLS_PER_STEP;
+    }
+
+    t = ui_perf_stamp();
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    for (rt_uint16_t i = 0; i < n; i++) {
+        SeatInfo *seat = db_get_seat(first + i);
+        status[i] = seat ? seat->status : SEAT_STATUS_NUM;
+        flags[i] = seat ? seat->flags : 0;
+    }
+    rt_mutex_release(seat_db.lock);
+    ui_perf_add(UI_PERF_DB_READ, t);
+
+    t = ui_perf_stamp();
+    for (rt_uint16_t i = 0; i < n; i++) {
+        rt_uint16_t cell = cell_cursor + i;
+        rt_uint16_t color = cell_color(status[i], flags[i]);
+
+        if (seat_bitmap_test(shown_valid, cell) && shown_color[cell] == color) {
+            pager_stats.cells_skipped++;
+            continue;
+        }
+        lcd_tile_fill_rect(CELL_X(cell), CELL_Y(cell), CELL_W - PAGE_GAP, CELL_H - PAGE_GAP, color);
+        pixels += (CELL_W - PAGE_GAP) * (CELL_H - PAGE_GAP);
+        shown_color[cell] = color;
+        seat_bitmap_set(shown_valid, cell);
+        pager_stats.cells_drawn++;
+    }
+
+    ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+    cell_cursor += n;
+    return pixels;
+}
+
+rt_bool_t ui_pager_refresh(void)
+{
+    rt_tick_t start = rt_tick_get();
+    rt_uint32_t pixels = 0;
+    rt_uint32_t gen;
+    rt_uint32_t t;
+
+    /* 定时翻页 */
+    if (SEAT_UI_PAGE_INTERVAL_MS > 0 && page_request < 0 &&
+        rt_tick_get() - last_flip >= rt_tick_from_millisecond(SEAT_UI_PAGE_INTERVAL_MS)) {
+        page_request = (page + 1) % SEAT_ZONE_COUNT;
+    }
+
+    if (page_request >= 0) {
+        page = page_request;
+        page_request = -1;
+        last_flip = rt_tick_get();
+        layout_pending = RT_TRUE;
+        strips_dirty = RT_TRUE;
+        cell_cursor = 0;
+        flip_pixels = 0;
+        pager_stats.flips++;
+    }
+
+
+    /* 统计各分区变化次数；当前页所在分区有变化时从头扫描本页 */
+    for (rt_uint16_t zone = 0; zone < SEAT_ZONE_COUNT; zone++) {
+        gen = db_zone_generation(zone);
+        if (gen != zone_seen[zone]) {
+            pager_stats.zone_changes[zone] += gen - zone_seen[zone];
+            zone_seen[zone] = gen;
+            if (zone == page) {
+                cell_cursor = 0;
+            }
+        }
+    }
+
+    t = ui_perf_stamp();
+    if (clear_row < 240) {
+        /* 整屏清除按行带分片，清除完成后重绘全部静态内容与格子 */
+        rt_uint16_t rows = 240 - clear_row < CLEAR_ROWS ? 240 - clear_row : CLEAR_ROWS;
+
+        lcd_tile_fill_rect(0, clear_row, 240, rows, WHITE);
+        pixels = 240 * rows;
+        clear_row += rows;
+        layout_pending = RT_TRUE;
+        strips_dirty = RT_FALSE;
+        cell_cursor = 0;
+    } else if (layout_pending) {
+        /* 静态内容单独作为一片 */
+        pixels = draw_layout();
+        layout_pending = RT_FALSE;
+    } else if (cell_cursor < zone_cells(page)) {
+        pixels = draw_cells_slice();
+        t = ui_perf_stamp();    // 格子片内部已分别计入读库与推送耗时
+    } else {
+        /* 本页已画完，空闲时光栅化下一页的标签，翻页时直接可用 */
+        layout_prepare((page + 1) % SEAT_ZONE_COUNT);
+        return RT_FALSE;
+    }
+    lcd_tile_sync();
+    ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+    flip_pixels += pixels;
+    pager_stats.flip_pixels_last = flip_pixels;
+    pager_stats.slices++;
+    if (pixels > pager_stats.slice_pixels_max) {
+        pager_stats.slice_pixels_max = pixels;
+    }
+    if (rt_tick_get() - start > pager_stats.slice_ticks_max) {
+        pager_stats.slice_ticks_max = rt_tick_get() - start;
+    }
+
+    return clear_row < 240 || layout_pending || cell_cursor < zone_cells(page);
+}
+
+void ui_pager_get_stats(ui_pager_stats_t *stats)
+{
+    *stats = pager_stats;
+}
+
+/* MSH命令：ui_page [next|页号]，无参数时显示统计 */
+static void ui_page(int argc, char **argv)
+{
+    if (argc > 1) {
+        if (strcmp(argv[1], "next") == 0) {
+            ui_pager_next();
+        } else {
+            ui_pager_goto(atoi(argv[1]));
+        }
+        return;
+    }
+
+    rt_kprintf("Page             : %d/%d (%d seats per page)\n", page, SEAT_ZONE_COUNT, SEAT_ZONE_SIZE);
+    rt_kprintf("Flips            : %d\n", pager_stats.flips);
+    rt_kprintf("Slices           : %d (max %d px, %d ticks)\n", pager_stats.slices,
+               pager_stats.slice_pixels_max, pager_stats.slice_ticks_max);
+    rt_kprintf("Cells drawn      : %d (skipped %d)\n", pager_stats.cells_drawn, pager_stats.cells_skipped);
+    rt_kprintf("Last flip pixels : %d\n", pager_stats.flip_pixels_last);
+    rt_kprintf("Zone changes     :");
+    for (rt_uint16_t zone = 0; zone < SEAT_ZONE_COUNT; zone++) {
+        rt_kprintf(" %d", pager_stats.zone_changes[zone]);
+    }
+    rt_kprintf("\n");
+}
+MSH_CMD_EXPORT(ui_page, paged zone view: ui_page [next|zone]);
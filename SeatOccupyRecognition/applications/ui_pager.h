@@ -0,0 +1,53 @@
+#ifndef __UI_PAGER_H__
+#define __UI_PAGER_H__
+
+#include <rtthread.h>
+#include "seat_db.h"
+
+/* 分页视图：每页显示一个分区（SEAT_ZONE_SIZE个座位），定时或按键翻页 */
+
+/* 自动翻页间隔，0为仅按键/命令翻页 */
+#ifndef SEAT_UI_PAGE_INTERVAL_MS
+#define SEAT_UI_PAGE_INTERVAL_MS    5000
+#endif
+
+/* 每个渲染片最多重绘的格子数，限制UI线程单次占用CPU的时间 */
+#ifndef SEAT_UI_PAGE_CELLS_PER_STEP
+#define SEAT_UI_PAGE_CELLS_PER_STEP 8
+#endif
+
+/* 翻页按键（RT-Spark KEY0，低电平有效） */
+#ifndef SEAT_UI_PAGE_KEY_PIN
+#define SEAT_UI_PAGE_KEY_PIN        GET_PIN(C, 0)
+#endif
+
+#define UI_PAGE_COLS        8
+#define UI_PAGE_ROWS        ((SEAT_ZONE_SIZE + UI_PAGE_COLS - 1) / UI_PAGE_COLS)
+
+#if UI_PAGE_ROWS > 8
+#error "SEAT_ZONE_SIZE too large for one LCD page"
+#endif
+
+typedef struct {
+    rt_uint32_t flips;              // 翻页次数
+    rt_uint32_t slices;             // 渲染片数
+    rt_uint32_t cells_drawn;        // 实际重绘的格子数
+    rt_uint32_t cells_skipped;      // 颜色未变而跳过的格子数
+    rt_uint32_t slice_pixels_max;   // 单片最大像素数
+    rt_tick_t slice_ticks_max;      // 单片最长耗时
+    rt_uint32_t flip_pixels_last;   // 最近一次翻页的总像素数
+    rt_uint32_t zone_changes[SEAT_ZONE_COUNT];  // 各分区观察到的变化次数
+} ui_pager_stats_t;
+
+/* 启动时从标签缓存区划出两页标签的缓冲，失败时标签改由字库直接绘制 */
+rt_err_t ui_pager_init(void);
+/* 屏幕已清空，下次刷新重绘当前页全部内容 */
+void ui_pager_invalidate(void);
+/* 请求翻到下一页/指定页，可在中断中调用 */
+void ui_pager_next(void);
+void ui_pager_goto(rt_uint16_t zone);
+/* 执行一个渲染片，仍有未完成的工作时返回RT_TRUE，调用者应短暂让出CPU后再次调用 */
+rt_bool_t ui_pager_refresh(void);
+void ui_pager_get_stats(ui_pager_stats_t *stats);
+
+#endif
@@ -0,0 +1,150 @@
+#include <rtthread.h>
+#include <string.h>
+#include <finsh.h>
+
+#include "ui_perf.h"
+
+#if defined(__linux__)
+#include <time.h>
+#else
+#include <board.h>
+#endif
+
+static ui_perf_stage_stats_t perf_stats[UI_PERF_STAGE_NUM];
+static rt_uint32_t frame_accum[UI_PERF_STAGE_NUM];
+static rt_uint32_t frame_start;
+static rt_bool_t frame_active;
+static rt_uint32_t counts_per_us;
+
+static const char *stage_names[UI_PERF_STAGE_NUM] = {
+    "db_read", "layout", "pixel_push", "total",
+};
+
+#if defined(__linux__)
+/* 主机端以纳秒为计数单位 */
+rt_uint32_t ui_perf_stamp(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+void ui_perf_init(void)
+{
+    counts_per_us = 1000;
+    ui_perf_reset();
+}
+#else
+/* Cortex-M4 DWT周期计数器，168MHz下约25秒回绕一次，求差不受影响 */
+rt_uint32_t ui_perf_stamp(void)
+{
+    return DWT->CYCCNT;
+}
+
+void ui_perf_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    counts_per_us = SystemCoreClock / 1000000;
+    ui_perf_reset();
+}
+#endif
+
+void ui_perf_frame_begin(void)
+{
+    rt_memset(frame_accum, 0, sizeof(frame_accum));
+    frame_start = ui_perf_stamp();
+    frame_active = RT_TRUE;
+}
+
+void ui_perf_add(ui_perf_stage_t stage, rt_uint32_t since)
+{
+    if (frame_active && stage < UI_PERF_TOTAL) {
+        frame_accum[stage] += ui_perf_stamp() - since;
+    }
+}
+
+static void record_sample(ui_perf_stage_stats_t *s, rt_uint32_t us)
+{
+    rt_uint32_t bucket = 0;
+
+    while (bucket < UI_PERF_BUCKETS - 1 && us >= (1UL << bucket)) {
+        bucket++;
+    }
+    s->hist[bucket]++;
+    s->window[s->count % UI_PERF_WINDOW] = us;
+    s->count++;
+}
+
+void ui_perf_frame_end(void)
+{
+    if (!frame_active || counts_per_us == 0) {
+        return;
+    }
+    frame_accum[UI_PERF_TOTAL] = ui_perf_stamp() - frame_start;
+    frame_active = RT_FALSE;
+
+    /* 未读数据库也未推送像素的空刷新不计入 */
+    if (frame_accum[UI_PERF_DB_READ] == 0 && frame_accum[UI_PERF_PIXEL_PUSH] == 0) {
+        return;
+    }
+
+    for (int i = 0; i < UI_PERF_STAGE_NUM; i++) {
+        record_sample(&perf_stats[i], frame_accum[i] / counts_per_us);
+    }
+}
+
+void ui_perf_reset(void)
+{
+    rt_memset(perf_stats, 0, sizeof(perf_stats));
+}
+
+void ui_perf_dump(void)
+{
+    rt_kprintf("%-11s %7s %7s %7s %7s  (us, last %d frames)\n",
+               "stage", "samples", "min", "avg", "max", UI_PERF_WINDOW);
+    for (int i = 0; i < UI_PERF_STAGE_NUM; i++) {
+        ui_perf_stage_stats_t *s = &perf_stats[i];
+        rt_uint32_t n = s->count < UI_PERF_WINDOW ? s->count : UI_PERF_WINDOW;
+        rt_uint32_t min = 0, max = 0, sum = 0;
+
+        for (rt_uint32_t k = 0; k < n; k++) {
+            if (k == 0 || s->window[k] < min) {
+                min = s->window[k];
+            }
+            if (s->window[k] > max) {
+                max = s->window[k];
+            }
+            sum += s->window[k];
+        }
+        rt_kprintf("%-11s %7d %7d %7d %7d\n", stage_names[i], s->count, min, n ? sum / n : 0, max);
+    }
+
+    rt_kprintf("histogram (us):");
+    for (int b = 0; b < UI_PERF_BUCKETS - 1; b++) {
+        rt_kprintf(" <%d", 1 << b);
+    }
+    rt_kprintf(" >=%d", 1 << (UI_PERF_BUCKETS - 2));
+    rt_kprintf("\n");
+    for (int i = 0; i < UI_PERF_STAGE_NUM; i++) {
+        rt_kprintf("%-11s", stage_names[i]);
+        for (int b = 0; b < UI_PERF_BUCKETS; b++) {
+            rt_kprintf(" %d", perf_stats[i].hist[b]);
+        }
+        rt_kprintf("\n");
+    }
+}
+
+/* MSH命令：ui_perf [reset] */
+static void ui_perf(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        ui_perf_reset();
+        return;
+    }
+    ui_perf_dump();
+}
+MSH_CMD_EXPORT(ui_perf, dump UI refresh stage timing: ui_perf [reset]);
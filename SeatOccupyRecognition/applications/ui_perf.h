@@ -0,0 +1,45 @@
+#ifndef __UI_PERF_H__
+#define __UI_PERF_H__
+
+#include <rtthread.h>
+
+/* UI刷新耗时统计：目标板用DWT周期计数器，主机用clock_gettime */
+
+/* 每阶段保留最近的样本数，用于滚动最小/平均/最大值 */
+#ifndef UI_PERF_WINDOW
+#define UI_PERF_WINDOW      32
+#endif
+
+/* 直方图桶数，第i桶为[2^(i-1), 2^i)微秒，第0桶为不足1微秒 */
+#define UI_PERF_BUCKETS     16
+
+typedef enum {
+    UI_PERF_DB_READ = 0,    // 持锁读取数据库快照
+    UI_PERF_LAYOUT,         // 文字格式化、颜色与坐标计算
+    UI_PERF_PIXEL_PUSH,     // 像素传输（含等待传输完成）
+    UI_PERF_TOTAL,          // 整次刷新
+    UI_PERF_STAGE_NUM,
+} ui_perf_stage_t;
+
+typedef struct {
+    rt_uint32_t window[UI_PERF_WINDOW];     // 最近样本（微秒）
+    rt_uint32_t count;                      // 累计样本数
+    rt_uint32_t hist[UI_PERF_BUCKETS];
+} ui_perf_stage_stats_t;
+
+void ui_perf_init(void);
+
+/* 当前计数值，仅用于求差 */
+rt_uint32_t ui_perf_stamp(void);
+
+/* 一次刷新的开始与结束；结束时把本次各阶段累计耗时记为一个样本 */
+void ui_perf_frame_begin(void);
+void ui_perf_frame_end(void);
+
+/* 把从since到现在的耗时累加到本次刷新的某个阶段 */
+void ui_perf_add(ui_perf_stage_t stage, rt_uint32_t since);
+
+void ui_perf_reset(void);
+void ui_perf_dump(void);
+
+#endif
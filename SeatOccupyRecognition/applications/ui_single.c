@@ -0,0 +1,133 @@
+#include <rtthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <drv_lcd.h>
+
+#include "ui_single.h"
+#include "seat_db.h"
+#include "lcd_colors.h"
+#include "lcd_tile.h"
+#include "label_cache.h"
+#include "ui_perf.h"
+#include "wifi_module.h"
+
+static rt_bool_t single_view_initialized = RT_FALSE;
+
+// 座位状态颜色映射（颜色定义见lcd_colors.h）
+rt_uint16_t seat_status_colors[] = {
+    GREEN,      // 空闲-绿色
+    RED,        // 使用中-红色
+    YELLOW      // 占座中-黄色
+};
+
+/* 绘制预光栅化标签（白色背景），未缓存时退回驱动逐字绘制 */
+static void show_label(rt_uint32_t id, rt_uint16_t x, rt_uint16_t y, rt_uint16_t color,
+                       rt_uint32_t size, const char *text)
+{
+    const lcd_label_t *label = label_cache_get(id);
+
+    if (label) {
+        label_cache_draw(label, x, y, color, WHITE);
+    } else {
+        lcd_tile_sync();
+        lcd_set_color(color, WHITE);
+        lcd_show_string(x, y, size, text);
+    }
+}
+
+/* 显示单个座位信息到LCD（仅修改数据来源） */
+void show_seat_on_lcd(void)
+{
+    static char last_seat_id[32] = {0};
+    static SeatStatus last_status = SEAT_AVAILABLE; // 记录上次状态
+    static rt_uint32_t last_generation = 0;         // 上次绘制时的数据库代数
+
+    /* 同一座位且数据库代数未变：重复写入，无需重绘 */
+    if (g_seat_data.new_data && single_view_initialized &&
+        db_generation() == last_generation &&
+        strcmp(g_seat_data.seat_id, last_seat_id) == 0) {
+        g_seat_data.new_data = RT_FALSE;
+        return;
+    }
+
+    if (g_seat_data.new_data && g_seat_data.seat_id[0] != '\0') {
+        rt_uint32_t t;
+
+        last_generation = db_generation();
+
+        // 首次显示或座位ID变化时显示标题、日期和座位ID
+        if (!single_view_initialized || strcmp(g_seat_data.seat_id, last_seat_id) != 0) {
+            // 显示标题和日期（预光栅化标签）
+            t = ui_perf_stamp();
+            show_label(LABEL_TITLE, 10, 20, BLACK, 24, "Seat Information");
+            show_label(LABEL_DATE, 10, 50, BLACK, 16, "Date: 2025-07-05");
+
+            // 绘制分隔线
+            lcd_tile_fill_rect(0, 75, 240, 1, BLACK);
+
+            // 显示座位ID（内容可变，由驱动绘制）
+            char seat_info[32];
+            lcd_tile_sync();
+            ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+            t = ui_perf_stamp();
+            rt_sprintf(seat_info, "Seat ID: %s", g_seat_data.seat_id);
+            ui_perf_add(UI_PERF_LAYOUT, t);
+
+            t = ui_perf_stamp();
+            lcd_set_color(BLACK, WHITE);
+            lcd_show_string(10, 90, 24, seat_info);
+            ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+            single_view_initialized = RT_TRUE;
+            strncpy(last_seat_id, g_seat_data.seat_id, sizeof(last_seat_id)-1);
+            last_seat_id[sizeof(last_seat_id)-1] = '\0';
+        }
+
+        // 从数据库获取座位状态，须在持锁期间读取
+        SeatStatus status = SEAT_AVAILABLE;
+        rt_bool_t found = RT_FALSE;
+        t = ui_perf_stamp();
+        if (rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER) == RT_EOK) {
+            SeatInfo *seat = db_get_seat(atoi(g_seat_data.seat_id));
+            if (seat) {
+                status = seat->status;
+                found = RT_TRUE;
+            }
+            rt_mutex_release(seat_db.lock);
+        }
+        ui_perf_add(UI_PERF_DB_READ, t);
+
+        if (!found) {
+            // 座位不存在时的处理（保持原有逻辑）
+            status = str_to_seat_status(g_seat_data.status);
+        }
+
+        /* 显示新状态文字（状态颜色+白色背景），标签自带背景像素 */
+        t = ui_perf_stamp();
+        show_label(LABEL_STATUS_WORD + status, 10, 170, seat_status_colors[status], 32,
+                   seat_status_strings[status]);
+
+        /* 旧状态文字更宽时，只需一次矩形填充清除多出的部分（32号字每字符16像素） */
+        rt_uint16_t old_w = rt_strlen(seat_status_strings[last_status]) * 16;
+        rt_uint16_t new_w = rt_strlen(seat_status_strings[status]) * 16;
+        if (old_w > new_w) {
+            lcd_tile_fill_rect(10 + new_w, 170, old_w - new_w, 32, WHITE);
+        }
+
+        /* 显示状态标题（黑色文字+白色背景） */
+        show_label(LABEL_STATUS, 10, 130, BLACK, 32, "Status:");
+        lcd_tile_sync();
+        ui_perf_add(UI_PERF_PIXEL_PUSH, t);
+
+        // 保存当前状态
+        last_status = status;
+
+        g_seat_data.new_data = RT_FALSE;
+    }
+}
+
+void ui_single_invalidate(void)
+{
+    single_view_initialized = RT_FALSE;
+}
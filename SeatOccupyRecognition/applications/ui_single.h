@@ -0,0 +1,11 @@
+#ifndef __UI_SINGLE_H__
+#define __UI_SINGLE_H__
+
+#include <rtthread.h>
+
+/* 单座位详情视图：显示g_seat_data指定座位的状态 */
+void show_seat_on_lcd(void);
+/* 下次刷新时重绘标题、日期等静态内容 */
+void ui_single_invalidate(void);
+
+#endif
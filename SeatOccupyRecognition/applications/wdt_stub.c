@@ -0,0 +1,99 @@
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <finsh.h>
+
+/* 看门狗设备桩：BSP未提供硬件看门狗驱动时（主机仿真或未启用BSP_USING_WDT）
+ * 注册同名"wdt"设备，soft_wdt的硬件喂狗路径可照常运行。
+ * 只记录喂狗节奏与超期情况，不会复位系统。 */
+#if defined(RT_USING_WDT) && !defined(BSP_USING_WDT)
+
+#define DBG_TAG "wdt_stub"
+#define DBG_LVL         DBG_LOG
+#include <rtdbg.h>
+
+typedef struct {
+    struct rt_watchdog_device wdt;
+    rt_uint32_t timeout_s;
+    rt_tick_t last_kick;
+    rt_bool_t started;
+    rt_uint32_t kicks;
+    rt_uint32_t overdue;        // 超时后才喂狗的次数，真实硬件此时已复位
+} wdt_stub_t;
+
+static wdt_stub_t wdt_stub;
+
+static rt_tick_t wdt_stub_elapsed(void)
+{
+    return rt_tick_get() - wdt_stub.last_kick;
+}
+
+static rt_err_t wdt_stub_init(rt_watchdog_t *wdt)
+{
+    return RT_EOK;
+}
+
+static rt_err_t wdt_stub_control(rt_watchdog_t *wdt, int cmd, void *arg)
+{
+    rt_tick_t limit = rt_tick_from_millisecond(wdt_stub.timeout_s * 1000);
+
+    switch (cmd) {
+    case RT_DEVICE_CTRL_WDT_SET_TIMEOUT:
+        wdt_stub.timeout_s = *(rt_uint32_t *)arg;
+        break;
+    case RT_DEVICE_CTRL_WDT_GET_TIMEOUT:
+        *(rt_uint32_t *)arg = wdt_stub.timeout_s;
+        break;
+    case RT_DEVICE_CTRL_WDT_GET_TIMELEFT:
+        *(rt_uint32_t *)arg = wdt_stub_elapsed() < limit ?
+                              (limit - wdt_stub_elapsed()) / RT_TICK_PER_SECOND : 0;
+        break;
+    case RT_DEVICE_CTRL_WDT_KEEPALIVE:
+        if (wdt_stub.started && wdt_stub_elapsed() > limit) {
+            wdt_stub.overdue++;
+            LOG_W("kick %d ms late, hardware watchdog would have reset",
+                  (wdt_stub_elapsed() - limit) * 1000 / RT_TICK_PER_SECOND);
+        }
+        wdt_stub.last_kick = rt_tick_get();
+        wdt_stub.kicks++;
+        break;
+    case RT_DEVICE_CTRL_WDT_START:
+        wdt_stub.started = RT_TRUE;
+        wdt_stub.last_kick = rt_tick_get();
+        break;
+    case RT_DEVICE_CTRL_WDT_STOP:
+        wdt_stub.started = RT_FALSE;
+        break;
+    default:
+        return -RT_EINVAL;
+    }
+    return RT_EOK;
+}
+
+static const struct rt_watchdog_ops wdt_stub_ops = {
+    wdt_stub_init,
+    wdt_stub_control,
+};
+
+static int wdt_stub_register(void)
+{
+    wdt_stub.wdt.ops = &wdt_stub_ops;
+    if (rt_hw_watchdog_register(&wdt_stub.wdt, "wdt", RT_DEVICE_FLAG_DEACTIVATE, RT_NULL) != RT_EOK) {
+        LOG_E("wdt stub register failed");
+        return -RT_ERROR;
+    }
+    LOG_I("No hardware watchdog driver, using stub device");
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(wdt_stub_register);
+
+static void wdt_stub_stat(int argc, char **argv)
+{
+    rt_kprintf("Started   : %s\n", wdt_stub.started ? "yes" : "no");
+    rt_kprintf("Timeout   : %d s\n", wdt_stub.timeout_s);
+    rt_kprintf("Since kick: %d ms\n", wdt_stub_elapsed() * 1000 / RT_TICK_PER_SECOND);
+    rt_kprintf("Kicks     : %d\n", wdt_stub.kicks);
+    rt_kprintf("Overdue   : %d\n", wdt_stub.overdue);
+}
+MSH_CMD_EXPORT(wdt_stub_stat, show stub watchdog device statistics);
+
+#endif /* RT_USING_WDT && !BSP_USING_WDT */
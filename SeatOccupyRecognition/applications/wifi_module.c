@@ -11,22 +11,30 @@
 #include <wlan_cfg.h>
 #include <msh.h>
 #include <drv_gpio.h>
+#include <spi_wifi_rw007.h>
+#include <netdev.h>
 
 #include "wifi_module.h"
+#include "ui_event.h"
+#include "soft_wdt.h"
+#include "seat_ingest.h"
 
 #define WLAN_SSID "redmik50"
 #define WLAN_PASSWORD "147258369"
 #define NET_READY_TIME_OUT (rt_tick_from_millisecond(15 * 1000))
 
-#define SERVER_PORT 8080
 #define CLIENT_IP "192.168.80.203"
 
+/* 接收超时：无数据时recvfrom按此周期返回，保证心跳持续 */
+#define UDP_RECV_TIMEOUT_MS     1000
+#define UDP_HEARTBEAT_MS        3000
+/* RW007驱动线程空闲时每RW007_HEARTBEAT_MS心跳一次 */
+#define RW007_DEADLINE_MS       (RW007_HEARTBEAT_MS * 3)
+
 #define LED_ON  1
 #define LED_OFF 0
 #define PIN_LED_R GET_PIN(F, 12)
 
-void update_database_from_udp(const char *seat_id_str, const char *status_str);
-
 rt_bool_t g_connected = RT_FALSE;
 rt_bool_t g_data_received = RT_FALSE;
 int g_blink_count = 0;
@@ -36,8 +44,12 @@ extern SeatData g_seat_data;  // 声明使用头文件中声明的全局变量
 
 static struct rt_semaphore net_ready;
 static struct rt_semaphore scan_done;
-static rt_thread_t udp_thread = RT_NULL;
+static struct rt_thread udp_thread;
+/* 接收路径经过lwIP recvfrom、strtok_r、日志与数据库提交，追踪流式输出时还要走lwIP sendto，
+ * 帧缓冲与追踪缓冲都不在栈上 */
+ALIGN(RT_ALIGN_SIZE) static rt_uint8_t udp_thread_stack[2048];
 static int sockfd = -1;
+static int rw007_wdt_ch[2] = {-1, -1};   // 按enum rw007_thread_id索引
 
 static void led_control(int state)
 {
@@ -111,6 +123,7 @@ void wlan_ready_handler(int event, struct rt_wlan_buff *buff, void *parameter)
 {
     rt_sem_release(&net_ready);
     g_connected = RT_TRUE;
+    ui_event_post(UI_EVT_WIFI_UP);
     rt_kprintf("网络连接就绪\n");
 }
 
@@ -118,12 +131,16 @@ void wlan_station_disconnect_handler(int event, struct rt_wlan_buff *buff, void
 {
     rt_kprintf("断开网络连接!\n");
     g_connected = RT_FALSE;
+    ui_event_post(UI_EVT_WIFI_DOWN);
     led_control(LED_OFF);
 }
 
 static void wlan_connect_handler(int event, struct rt_wlan_buff *buff, void *parameter)
 {
     rt_kprintf("已连接到SSID: %s\n", ((struct rt_wlan_info *)buff->data)->ssid.val);
+    /* 自动重连成功后恢复连接标志（READY回调在初始化后已注销） */
+    g_connected = RT_TRUE;
+    ui_event_post(UI_EVT_WIFI_UP);
 }
 
 static void wlan_connect_fail_handler(int event, struct rt_wlan_buff *buff, void *parameter)
@@ -131,47 +148,52 @@ static void wlan_connect_fail_handler(int event, struct rt_wlan_buff *buff, void
     rt_kprintf("连接SSID失败: %s\n", ((struct rt_wlan_info *)buff->data)->ssid.val);
 }
 
+/* RW007驱动线程心跳钩子 */
+static void rw007_heartbeat(enum rw007_thread_id thread)
+{
+    soft_wdt_heartbeat(g_soft_wdt, rw007_wdt_ch[thread]);
+}
+
+/* 本机发出的数据报：源地址为127.0.0.1，或经lwIP回环时为本机接口地址 */
+static rt_bool_t udp_from_self(rt_uint32_t addr)
+{
+    return addr == htonl(INADDR_LOOPBACK) ||
+           (netdev_default != RT_NULL && addr == netdev_default->ip_addr.addr);
+}
+
 /* UDP接收线程修改部分 */
 void udp_recv_thread(void *parameter) {
     struct sockaddr_in client_addr;
-    socklen_t client_addr_len = sizeof(client_addr);
-    char recv_buf[32] = {0};
-    char *token = RT_NULL;
+    socklen_t client_addr_len;
+    static char recv_buf[384];  // 可容纳一帧批量座位数据，只有本线程使用
+    int wdt_ch = soft_wdt_register(g_soft_wdt, "udp_recv", UDP_HEARTBEAT_MS);
 
     while (1) {
-        if (g_connected) {
-            int recv_len = recvfrom(sockfd, recv_buf, sizeof(recv_buf) - 1, 0,
-                                    (struct sockaddr*)&client_addr, &client_addr_len);
-            if (recv_len > 0) {
-                recv_buf[recv_len] = '\0';
-                g_data_received = RT_TRUE;
-
-                if (strcmp(inet_ntoa(client_addr.sin_addr), CLIENT_IP) == 0) {
-                    rt_kprintf("从 %s 接收到数据: %s\n", inet_ntoa(client_addr.sin_addr), recv_buf);
-
-                    /* 解析字符串格式 "座位ID:状态" */
-                    token = strtok(recv_buf, ":");
-                    if (token) {
-                        char seat_id[10] = {0};
-                        char status[10] = {0};
-                        strncpy(seat_id, token, sizeof(seat_id) - 1);
-
-                        token = strtok(NULL, ":");
-                        if (token) {
-                            strncpy(status, token, sizeof(status) - 1);
-
-                            // 调用数据库更新函数
-                            update_database_from_udp(seat_id, status);
-                        }
-                    }
-                }
-                else {
-                    rt_kprintf("忽略来自非指定客户端的数据: %s\n", inet_ntoa(client_addr.sin_addr));
-                }
-            }
+        soft_wdt_heartbeat(g_soft_wdt, wdt_ch);
+
+        if (!g_connected) {
+            rt_thread_mdelay(100);
+            continue;
         }
 
-        rt_thread_mdelay(100);
+        /* 每次调用前重置地址长度，recvfrom会改写它 */
+        client_addr_len = sizeof(client_addr);
+        int recv_len = recvfrom(sockfd, recv_buf, sizeof(recv_buf) - 1, 0,
+                                (struct sockaddr*)&client_addr, &client_addr_len);
+        if (recv_len > 0) {
+            recv_buf[recv_len] = '\0';
+            g_data_received = RT_TRUE;
+
+            /* 指定的识别板，或本机负载发生器(udp_load) */
+            if (strcmp(inet_ntoa(client_addr.sin_addr), CLIENT_IP) == 0 ||
+                udp_from_self(client_addr.sin_addr.s_addr)) {
+                seat_ingest_datagram(recv_buf, client_addr.sin_addr.s_addr,
+                                     ntohs(client_addr.sin_port));
+            }
+            else {
+                rt_kprintf("忽略来自非指定客户端的数据: %s\n", inet_ntoa(client_addr.sin_addr));
+            }
+        }
     }
 }
 /* 自动连接配置 */
@@ -193,6 +215,11 @@ int wifi_module_init(void)
     rt_pin_mode(PIN_LED_R, PIN_MODE_OUTPUT);
     led_control(LED_OFF);
 
+    /* RW007驱动线程在板级初始化时已启动，此处接入心跳监督 */
+    rw007_wdt_ch[RW007_THREAD_XFER] = soft_wdt_register(g_soft_wdt, "wifi_xfer", RW007_DEADLINE_MS);
+    rw007_wdt_ch[RW007_THREAD_HANDLE] = soft_wdt_register(g_soft_wdt, "wifi_handle", RW007_DEADLINE_MS);
+    rw007_heartbeat_sethook(rw007_heartbeat);
+
     rt_sem_init(&scan_done, "scan_done", 0, RT_IPC_FLAG_FIFO);
     rt_wlan_register_event_handler(RT_WLAN_EVT_SCAN_REPORT, wlan_scan_report_hander, &i);
     rt_wlan_register_event_handler(RT_WLAN_EVT_SCAN_DONE, wlan_scan_done_hander, RT_NULL);
@@ -220,7 +247,7 @@ int wifi_module_init(void)
             struct sockaddr_in server_addr = {0};
             server_addr.sin_family = AF_INET;
             server_addr.sin_addr.s_addr = INADDR_ANY;
-            server_addr.sin_port = htons(SERVER_PORT);
+            server_addr.sin_port = htons(SEAT_INGEST_PORT);
 
             if (bind(sockfd, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0)
             {
@@ -229,9 +256,16 @@ int wifi_module_init(void)
                 return -1;
             }
 
-            udp_thread = rt_thread_create("udp_recv", udp_recv_thread, RT_NULL, 1024, RT_THREAD_PRIORITY_MAX / 2, 20);
-            if (udp_thread)
-                rt_thread_startup(udp_thread);
+            /* 阻塞接收设置超时，线程空闲时也能按时心跳 */
+            struct timeval tv;
+            tv.tv_sec = UDP_RECV_TIMEOUT_MS / 1000;
+            tv.tv_usec = (UDP_RECV_TIMEOUT_MS % 1000) * 1000;
+            setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+            if (rt_thread_init(&udp_thread, "udp_recv", udp_recv_thread, RT_NULL,
+                               udp_thread_stack, sizeof(udp_thread_stack),
+                               RT_THREAD_PRIORITY_MAX / 2, 20) == RT_EOK)
+                rt_thread_startup(&udp_thread);
             else
             {
                 close(sockfd);
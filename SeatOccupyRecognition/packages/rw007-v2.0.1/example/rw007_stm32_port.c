@@ -67,4 +67,86 @@ void spi_wifi_hw_init(void)
     rt_pin_irq_enable(RW007_INT_BUSY_PIN, RT_TRUE);
 }
 
+#ifdef RW007_USING_SPI_DMA
+/* The bus driver owns the DMA streams and their interrupts (BSP_SPIx_TX_USING_DMA
+ * and BSP_SPIx_RX_USING_DMA), but it spins on the HAL state until a DMA transfer
+ * ends. The data phase is started here instead and completes in the HAL
+ * callbacks, so the transfer thread sleeps while the frame is clocked out. */
+static SPI_HandleTypeDef *rw007_spi_handle = RT_NULL;
+static volatile rt_bool_t rw007_dma_busy = RT_FALSE;
+
+rt_err_t spi_wifi_dma_start(struct rt_spi_device *device, const void *send_buf, void *recv_buf, rt_size_t length)
+{
+    struct stm32_spi *spi_drv = rt_container_of(device->bus, struct stm32_spi, spi_bus);
+    HAL_StatusTypeDef state;
+
+    if (!(spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) || !(spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG))
+    {
+        return -RT_ENOSYS;
+    }
+
+    rw007_spi_handle = &spi_drv->handle;
+    rw007_dma_busy = RT_TRUE;
+    if (send_buf && recv_buf)
+    {
+        state = HAL_SPI_TransmitReceive_DMA(rw007_spi_handle, (uint8_t *)send_buf, (uint8_t *)recv_buf, length);
+    }
+    else if (send_buf)
+    {
+        state = HAL_SPI_Transmit_DMA(rw007_spi_handle, (uint8_t *)send_buf, length);
+    }
+    else
+    {
+        state = HAL_SPI_Receive_DMA(rw007_spi_handle, (uint8_t *)recv_buf, length);
+    }
+
+    if (state != HAL_OK)
+    {
+        rw007_dma_busy = RT_FALSE;
+        return -RT_ERROR;
+    }
+    return RT_EOK;
+}
+
+void spi_wifi_dma_stop(struct rt_spi_device *device)
+{
+    if (rw007_dma_busy)
+    {
+        rw007_dma_busy = RT_FALSE;
+        HAL_SPI_Abort(rw007_spi_handle);
+    }
+}
+
+/* the callbacks also fire for the bus driver's own DMA transfers, only the
+ * data phase started above is reported */
+static void rw007_dma_complete(SPI_HandleTypeDef *hspi, rt_err_t result)
+{
+    if ((hspi == rw007_spi_handle) && rw007_dma_busy)
+    {
+        rw007_dma_busy = RT_FALSE;
+        spi_wifi_dma_done(result);
+    }
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    rw007_dma_complete(hspi, RT_EOK);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    rw007_dma_complete(hspi, RT_EOK);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    rw007_dma_complete(hspi, RT_EOK);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    rw007_dma_complete(hspi, -RT_EIO);
+}
+#endif /* RW007_USING_SPI_DMA */
+
 #endif /* RW007_USING_STM32_DRIVERS */
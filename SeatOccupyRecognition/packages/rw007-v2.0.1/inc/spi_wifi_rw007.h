@@ -69,8 +69,39 @@ struct spi_slave_response
 
 /* spi buffer configure. */
 #define SPI_MAX_DATA_LEN 1520
+#ifndef SPI_TX_POOL_SIZE
 #define SPI_TX_POOL_SIZE 4
+#endif
+#ifndef SPI_RX_POOL_SIZE
 #define SPI_RX_POOL_SIZE 4
+#endif
+/* zero-copy tx queues a reference to the lwIP pbuf chain. Only lwIP 2.1+
+ * checks that reference (tcp_output_segment_busy) before a retransmission
+ * rewrites a TCP segment still waiting here; older stacks get a copy. */
+#ifdef RT_WLAN_PROT_LWIP_PBUF_FORCE
+#include <lwip/init.h>
+#if LWIP_VERSION >= 0x02010000
+#define RW007_TX_ZERO_COPY
+#endif
+#endif
+/* zero-copy tx descriptors, one per lwIP frame in flight */
+#ifndef SPI_TX_PBUF_POOL_SIZE
+#define SPI_TX_PBUF_POOL_SIZE 8
+#endif
+#ifdef RW007_TX_ZERO_COPY
+#define SPI_TX_MB_SIZE (SPI_TX_POOL_SIZE + SPI_TX_PBUF_POOL_SIZE)
+#else
+#define SPI_TX_MB_SIZE SPI_TX_POOL_SIZE
+#endif
+/* rx burst: transfers run back to back in one wakeup while the slave
+ * reports pending frames, waiting up to RW007_RX_POOL_WAIT_MS for a free
+ * rx pool buffer when the pool runs dry. 1 restores one transfer per event. */
+#ifndef RW007_RX_BURST_MAX
+#define RW007_RX_BURST_MAX 16
+#endif
+#ifndef RW007_RX_POOL_WAIT_MS
+#define RW007_RX_POOL_WAIT_MS 10
+#endif
 /*  The slave interrupts wait timeout */
 #define SLAVE_INT_TIMEOUT  100
 
@@ -97,6 +128,16 @@ struct spi_data_packet
     char buffer[SPI_MAX_DATA_LEN];
 };
 
+/* zero-copy tx: the pbuf chain is clocked out behind the same two header
+ * words as struct spi_data_packet, the header is the only part copied */
+struct pbuf;
+struct spi_data_pbuf
+{
+    uint32_t data_len;  /* frame length, p->tot_len */
+    uint32_t data_type; /* app_data_type_t */
+    struct pbuf *p;     /* referenced until the slave accepts the frame */
+};
+
 typedef struct rw007_ap_info_value
 {
     struct rt_wlan_info info;
@@ -181,7 +222,14 @@ struct rw007_spi
     ALIGN(RT_ALIGN_SIZE)
     rt_uint8_t spi_tx_mempool[(sizeof(struct spi_data_packet) + 4) * SPI_TX_POOL_SIZE];
     struct rt_mailbox spi_tx_mb;
-    rt_ubase_t spi_tx_mb_pool[SPI_TX_POOL_SIZE + 1];
+    rt_ubase_t spi_tx_mb_pool[SPI_TX_MB_SIZE + 1];
+
+#ifdef RW007_TX_ZERO_COPY
+    /* Tx pbuf descriptors, queued on spi_tx_mb with the packets */
+    struct rt_mempool spi_tx_pbuf_mp;
+    ALIGN(RT_ALIGN_SIZE)
+    rt_uint8_t spi_tx_pbuf_mempool[(sizeof(struct spi_data_pbuf) + 4) * SPI_TX_PBUF_POOL_SIZE];
+#endif
 
     /* Rx mempool and mailbox */
     struct rt_mempool spi_rx_mp;
@@ -192,8 +240,12 @@ struct rw007_spi
 
     /* response event */
     rt_event_t rw007_cmd_event;
-    /* response data */
-    struct rw007_resp *resp[RW00x_CMD_MAX_NUM];
+    /* response slots: the rx pool packet carrying each command's response,
+     * handed over by the dispatch thread and freed by the waiter */
+    const struct spi_data_packet *resp[RW00x_CMD_MAX_NUM];
+    /* commands with a caller waiting in spi_cmd_request, by RW00x_CMD_RESP_EVENT
+     * bit; a response for any other command is freed on arrival */
+    rt_uint32_t resp_waiting;
 };
 
 #define RW00x_CMD_RESP_EVENT(n)     (0x01UL << n)
@@ -209,11 +261,35 @@ struct rw007_wifi
 /* porting */
 extern void spi_wifi_hw_init(void);
 
+#ifdef RW007_USING_SPI_DMA
+/* data phase on DMA: the port starts the transfer without blocking and calls
+ * spi_wifi_dma_done() from the completion (or error) interrupt, the transfer
+ * thread sleeps in between. CS is already asserted by the response header
+ * transfer and is released by the driver afterwards. */
+extern rt_err_t spi_wifi_dma_start(struct rt_spi_device *device, const void *send_buf, void *recv_buf, rt_size_t length);
+extern void spi_wifi_dma_stop(struct rt_spi_device *device);
+extern void spi_wifi_dma_done(rt_err_t result);
+#endif
+
 /* end porting */
 
 /* api exclude in wlan framework */
 extern rt_err_t rw007_sn_get(char sn[24]);
 extern rt_err_t rw007_version_get(char version[16]);
+
+/* driver thread heartbeat: the threads wait at most RW007_HEARTBEAT_MS and
+ * call the hook on every loop pass, so a supervisor can tell idle from hung */
+#ifndef RW007_HEARTBEAT_MS
+#define RW007_HEARTBEAT_MS          1000
+#endif
+
+enum rw007_thread_id
+{
+    RW007_THREAD_XFER = 0,          /* "wifi_xfer" spi transfer thread */
+    RW007_THREAD_HANDLE,            /* "wifi_handle" rx packet dispatch thread */
+};
+
+extern void rw007_heartbeat_sethook(void (*hook)(enum rw007_thread_id thread));
 /* end api exclude in wlan framework */
 
 extern rt_err_t rt_hw_wifi_init(const char *spi_device_name);
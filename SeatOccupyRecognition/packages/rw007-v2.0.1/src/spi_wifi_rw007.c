@@ -28,12 +28,65 @@
 
 #include "spi_wifi_rw007.h"
 
+#ifdef RT_WLAN_PROT_LWIP_PBUF_FORCE
+#include <lwip/pbuf.h>
+#endif
+
 static struct rw007_spi rw007_spi;
 static struct rw007_wifi wifi_sta, wifi_ap;
 static struct rt_event spi_wifi_data_event;
 static rt_bool_t inited = RT_FALSE;
+static void (*rw007_heartbeat_hook)(enum rw007_thread_id thread) = RT_NULL;
+
+#define RW007_HEARTBEAT(thread)                 \
+    do                                          \
+    {                                           \
+        if (rw007_heartbeat_hook)               \
+        {                                       \
+            rw007_heartbeat_hook(thread);       \
+        }                                       \
+    } while (0)
+
+void rw007_heartbeat_sethook(void (*hook)(enum rw007_thread_id thread))
+{
+    rw007_heartbeat_hook = hook;
+}
+
+/* packet being offered to the slave, and the one fetched behind it while
+ * the data phase of the previous transfer was on the bus. Either one is a
+ * struct spi_data_packet or, from the pbuf pool, a struct spi_data_pbuf. */
+static const struct spi_data_packet *tx_active = RT_NULL;
+static const struct spi_data_packet *tx_staged = RT_NULL;
+
+#define SPI_DATA_HEAD_LEN   member_offset(struct spi_data_packet, buffer)
+
+/* the slave reported more frames to send in the last transfer */
+static rt_bool_t rx_pending = RT_FALSE;
+
+/* rx burst length buckets: 1, 2, 3-4, 5-8, 9 and more transfers */
+#define RX_BURST_BUCKETS    5
+
+#ifdef RW007_USING_SPI_DMA
+static struct rt_semaphore spi_dma_sem;
+static volatile rt_err_t spi_dma_result;
+#endif
 
 #ifdef WLAN_DEV_MONITOR
+/* transfer time source. Cortex-M3/M4/M7 use the DWT cycle counter, enabled
+ * in rt_hw_wifi_init, so the data phase of a single frame is resolved;
+ * other cores fall back to ticks. Define both macros to override. */
+#ifndef RW007_XFER_CLOCK
+#if defined(ARCH_ARM_CORTEX_M3) || defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7)
+#include <board.h>
+#define RW007_XFER_CLOCK_DWT
+#define RW007_XFER_CLOCK()          (DWT->CYCCNT)
+#define RW007_XFER_CLOCK_HZ         SystemCoreClock
+#else
+#define RW007_XFER_CLOCK()          rt_tick_get()
+#define RW007_XFER_CLOCK_HZ         RT_TICK_PER_SECOND
+#endif
+#endif
+
 typedef struct
 {
     rt_uint32_t total;
@@ -41,18 +94,234 @@ typedef struct
     rt_uint32_t retry;
     rt_uint32_t first_stage_err;
     rt_uint32_t second_stage_err;
+    rt_uint32_t xfer_count;         /* completed transfers */
+    rt_uint64_t xfer_time;          /* command + data phase, RW007_XFER_CLOCK units */
+    rt_uint32_t xfer_time_max;
+    rt_uint64_t data_time;          /* data phase only */
+    rt_uint32_t data_bytes;         /* bytes clocked in data phases */
+    rt_uint32_t dma_xfer;           /* data phases run on DMA */
+    rt_uint32_t dma_err;            /* DMA failed or timed out */
+    rt_uint32_t tx_staged;          /* tx packets fetched during a data phase */
+    rt_uint32_t tx_zero_copy;       /* frames sent straight from pbufs */
+    rt_uint32_t resp_stale;         /* responses nobody was waiting for */
+    rt_uint32_t rx_bursts;          /* wakeups of the transfer thread */
+    rt_uint32_t rx_burst_xfers;     /* transfers run in those wakeups */
+    rt_uint32_t rx_burst_max;
+    rt_uint32_t rx_burst_hist[RX_BURST_BUCKETS];
+    rt_uint32_t rx_pool_empty;      /* transfers that found no free rx buffer */
+    rt_uint32_t rx_pool_timeout;    /* of those, still none after waiting */
+    rt_uint32_t rx_pool_min_free;   /* low watermark of free rx buffers */
+    /* occupancy histograms: tx queue depth after each enqueue, rx buffers
+     * in use after each transfer's allocation */
+    rt_uint32_t tx_queue_hist[SPI_TX_MB_SIZE + 1];
+    rt_uint32_t rx_pool_hist[SPI_RX_POOL_SIZE + 1];
+    rt_uint32_t tx_blocked;         /* wlan_send calls that waited for a tx block */
+    rt_uint64_t tx_blocked_time;    /* time spent waiting, RW007_XFER_CLOCK units */
+    rt_uint32_t tx_blocked_max;
+    rt_uint32_t tx_dropped;         /* frames dropped on a full pool */
 } net_packet;
 net_packet packet;
 #endif
 
+#ifdef RW007_TX_ZERO_COPY
+rt_inline const struct spi_data_pbuf *wifi_tx_as_pbuf(struct rw007_spi *dev, const void *item)
+{
+    const rt_uint8_t *addr = (const rt_uint8_t *)item;
+
+    if ((addr >= dev->spi_tx_pbuf_mempool) &&
+        (addr < dev->spi_tx_pbuf_mempool + sizeof(dev->spi_tx_pbuf_mempool)))
+    {
+        return (const struct spi_data_pbuf *)item;
+    }
+    return RT_NULL;
+}
+#endif
+
+static void wifi_tx_free(struct rw007_spi *dev, const struct spi_data_packet *item)
+{
+#ifdef RW007_TX_ZERO_COPY
+    const struct spi_data_pbuf *data_pbuf = wifi_tx_as_pbuf(dev, item);
+
+    if (data_pbuf != RT_NULL)
+    {
+        pbuf_free(data_pbuf->p);
+    }
+#endif
+    rt_mp_free((void *)item);
+}
+
+/* fetch the next tx packet, malformed ones are dropped */
+static const struct spi_data_packet *wifi_tx_fetch(struct rw007_spi *dev)
+{
+    const struct spi_data_packet *data_packet;
+
+    while (rt_mb_recv(&dev->spi_tx_mb, (rt_ubase_t *)&data_packet, RT_WAITING_NO) == RT_EOK)
+    {
+        if ((data_packet->data_len != 0) && (data_packet->data_len <= SPI_MAX_DATA_LEN))
+        {
+            return data_packet;
+        }
+        wifi_tx_free(dev, data_packet);
+    }
+    return RT_NULL;
+}
+
+/* clock one piece of the data phase with CS held. Only the DMA path can
+ * report a failure, the bus xfer op has no error return. */
+static rt_err_t wifi_data_segment(struct rw007_spi *dev, const void *send_buf, void *recv_buf, rt_uint32_t length)
+{
+    struct rt_spi_device *rt_spi_device = dev->spi_device;
+    struct rt_spi_message message;
+
+#ifdef RW007_USING_SPI_DMA
+    if (((send_buf != RT_NULL) || (recv_buf != RT_NULL)) &&
+        (spi_wifi_dma_start(rt_spi_device, send_buf, recv_buf, length) == RT_EOK))
+    {
+        /* the bus is busy clocking: fetch the packet for the next transfer */
+        if (tx_staged == RT_NULL)
+        {
+            tx_staged = wifi_tx_fetch(dev);
+#ifdef WLAN_DEV_MONITOR
+            if (tx_staged != RT_NULL)
+            {
+                packet.tx_staged++;
+            }
+#endif
+        }
+
+        if (rt_sem_take(&spi_dma_sem, SLAVE_INT_TIMEOUT) != RT_EOK)
+        {
+            spi_wifi_dma_stop(rt_spi_device);
+            /* the completion may have raced the stop */
+            rt_sem_control(&spi_dma_sem, RT_IPC_CMD_RESET, RT_NULL);
+            spi_dma_result = -RT_ETIMEOUT;
+        }
+#ifdef WLAN_DEV_MONITOR
+        packet.dma_xfer++;
+#endif
+        if (spi_dma_result != RT_EOK)
+        {
+#ifdef WLAN_DEV_MONITOR
+            packet.dma_err++;
+#endif
+            LOG_E("The wifi data phase DMA error %d\r", spi_dma_result);
+            return spi_dma_result;
+        }
+        return RT_EOK;
+    }
+#endif /* RW007_USING_SPI_DMA */
+
+    message.send_buf = send_buf;
+    message.recv_buf = recv_buf;
+    message.length = length;
+    message.cs_take = 0;
+    message.cs_release = 0;
+    rt_spi_device->bus->ops->xfer(rt_spi_device, &message);
+    return RT_EOK;
+}
+
+#ifdef RW007_TX_ZERO_COPY
+/* clocked out behind a pbuf frame when nothing is being received: the word
+ * alignment tail never reaches the bus with both buffers RT_NULL */
+static const rt_uint8_t wifi_tx_pad[4] = {0};
+#endif
+
+/* Stage 2 data phase: tx_item (may be RT_NULL) goes out while rx_buffer
+ * (may be RT_NULL) fills, CS is held from the response header and released
+ * here. A pbuf frame is gathered segment by segment, the rest is padding.
+ * Stops at the first failed segment; CS is released either way. */
+static rt_err_t wifi_data_phase(struct rw007_spi *dev, const struct spi_data_packet *tx_item,
+                                uint8_t *rx_buffer, rt_uint32_t length)
+{
+    struct rt_spi_device *rt_spi_device = dev->spi_device;
+    struct rt_spi_message message;
+    const void *send_buf = tx_item;
+    rt_uint32_t offset = 0;
+    rt_uint32_t seg_len;
+    rt_err_t result = RT_EOK;
+#ifdef RW007_TX_ZERO_COPY
+    const struct spi_data_pbuf *data_pbuf = wifi_tx_as_pbuf(dev, tx_item);
+    struct pbuf *q = RT_NULL;
+#endif
+
+    while (offset < length)
+    {
+        seg_len = length - offset;
+#ifdef RW007_TX_ZERO_COPY
+        if (data_pbuf != RT_NULL)
+        {
+            if (offset == 0)
+            {
+                send_buf = data_pbuf;
+                seg_len = SPI_DATA_HEAD_LEN;
+                q = data_pbuf->p;
+            }
+            else if (q != RT_NULL)
+            {
+                send_buf = q->payload;
+                seg_len = q->len;
+                q = q->next;
+            }
+            else if (rx_buffer != RT_NULL)
+            {
+                /* receive-only for the rest of the rx frame */
+                send_buf = RT_NULL;
+            }
+            else
+            {
+                send_buf = wifi_tx_pad;
+                if (seg_len > sizeof(wifi_tx_pad))
+                {
+                    seg_len = sizeof(wifi_tx_pad);
+                }
+            }
+
+            if (seg_len > length - offset)
+            {
+                seg_len = length - offset;
+            }
+        }
+#endif
+        if (seg_len > 0)
+        {
+            result = wifi_data_segment(dev, send_buf, rx_buffer ? rx_buffer + offset : RT_NULL, seg_len);
+            if (result != RT_EOK)
+            {
+                break;
+            }
+            offset += seg_len;
+        }
+    }
+
+    message.send_buf = RT_NULL;
+    message.recv_buf = RT_NULL;
+    message.length = 0;
+    message.cs_take = 0;
+    message.cs_release = 1;
+    rt_spi_device->bus->ops->xfer(rt_spi_device, &message);
+    return result;
+}
+
+#ifdef RW007_USING_SPI_DMA
+void spi_wifi_dma_done(rt_err_t result)
+{
+    spi_dma_result = result;
+    rt_sem_release(&spi_dma_sem);
+}
+#endif
+
 static int wifi_data_transfer(struct rw007_spi *dev, uint16_t seq, uint8_t *rx_buffer)
 {
-    static const struct spi_data_packet *send_packet = RT_NULL;
     struct spi_master_request cmd;
     struct spi_slave_response resp;
     struct rt_spi_message message;
     struct rt_spi_device *rt_spi_device = dev->spi_device;
     rt_uint32_t max_data_len = 0;
+    uint8_t *rx_data;
+#ifdef WLAN_DEV_MONITOR
+    rt_uint32_t xfer_start = RW007_XFER_CLOCK();
+    rt_uint32_t data_start, elapsed;
+#endif
 
     /* Clear cmd */
     rt_memset(&cmd, 0, sizeof(cmd));
@@ -68,28 +337,17 @@ static int wifi_data_transfer(struct rw007_spi *dev, uint16_t seq, uint8_t *rx_b
         cmd.flag |= MASTER_FLAG_MRDY;
     }
 
-    if (send_packet == RT_NULL)
+    if (tx_active == RT_NULL)
     {
-        /* Check to see if any data needs to be sent */
-        if (rt_mb_recv(&dev->spi_tx_mb, (rt_ubase_t *)&send_packet, RT_WAITING_NO) != RT_EOK)
-        {
-            send_packet = RT_NULL;
-        }
+        /* Check to see if any data needs to be sent, the staged packet goes first */
+        tx_active = (tx_staged != RT_NULL) ? tx_staged : wifi_tx_fetch(dev);
+        tx_staged = RT_NULL;
     }
 
     /* Set length for master to slave when data ready*/
-    if (send_packet != RT_NULL)
+    if (tx_active != RT_NULL)
     {
-        /* Invalid data packet */
-        if((send_packet->data_len == 0) || (send_packet->data_len > SPI_MAX_DATA_LEN))
-        {
-            rt_mp_free((void *)send_packet);
-            send_packet = RT_NULL;     
-        }
-        else
-        {
-            cmd.M2S_len = send_packet->data_len + member_offset(struct spi_data_packet, buffer);
-        }
+        cmd.M2S_len = tx_active->data_len + SPI_DATA_HEAD_LEN;
     }
 
     /* Stage 1: Send command to rw007 */
@@ -164,36 +422,48 @@ static int wifi_data_transfer(struct rw007_spi *dev, uint16_t seq, uint8_t *rx_b
         max_data_len = resp.S2M_len;
     }
 
-    /* Setup message */
-    if((resp.S2M_len == 0) && (rx_buffer != RT_NULL))
-    {
-        rt_mp_free(rx_buffer);
-        rx_buffer = RT_NULL;
-    }
+    /* Setup message: nothing to receive without S2M_len. rx_buffer stays
+     * with the caller until the data phase succeeds, a failed one is retried
+     * with the same buffer. */
+    rx_data = (resp.S2M_len != 0) ? rx_buffer : RT_NULL;
 
-    message.send_buf = send_packet;
-    message.recv_buf = rx_buffer;
-    message.length = RT_ALIGN(max_data_len, 4);/* align clk to word */
-    message.cs_take = 0;
-    message.cs_release = 1;
+    max_data_len = RT_ALIGN(max_data_len, 4);/* align clk to word */
 
     /* Transmit data */
-    rt_spi_device->bus->ops->xfer(rt_spi_device, &message);
+#ifdef WLAN_DEV_MONITOR
+    data_start = RW007_XFER_CLOCK();
+    packet.data_bytes += max_data_len;
+#endif
+    if (wifi_data_phase(dev, tx_active, rx_data, max_data_len) != RT_EOK)
+    {
+        /* the slave may not have the frame: tx_active stays for the retry,
+         * the partly filled rx buffer is never posted */
+        rt_spi_release_bus(rt_spi_device);
+        goto _cmderr;
+    }
+#ifdef WLAN_DEV_MONITOR
+    packet.data_time += RW007_XFER_CLOCK() - data_start;
+#endif
 
     /* End a SPI transmit */
     rt_spi_release_bus(rt_spi_device);
 
+    if ((rx_data == RT_NULL) && (rx_buffer != RT_NULL))
+    {
+        rt_mp_free(rx_buffer);
+    }
+
     /* Free send data space */
-    if ((resp.flag & SLAVE_FLAG_SRDY) && (send_packet != RT_NULL))
+    if ((resp.flag & SLAVE_FLAG_SRDY) && (tx_active != RT_NULL))
     {
-        rt_mp_free((void *)send_packet);
-        send_packet = RT_NULL;
+        wifi_tx_free(dev, tx_active);
+        tx_active = RT_NULL;
     }
 
     /* Parse recevied data */
-    if(rx_buffer)
+    if(rx_data)
     {
-        rt_mb_send(&dev->spi_rx_mb, (rt_ubase_t)rx_buffer);
+        rt_mb_send(&dev->spi_rx_mb, (rt_ubase_t)rx_data);
     }
 
     /* receive data end event */
@@ -206,8 +476,19 @@ static int wifi_data_transfer(struct rw007_spi *dev, uint16_t seq, uint8_t *rx_b
         LOG_E("The wifi slave data response timed out\r");
     }
 
-    /* The slave has data */
-    if (resp.slave_tx_buf > 0)
+#ifdef WLAN_DEV_MONITOR
+    elapsed = RW007_XFER_CLOCK() - xfer_start;
+    packet.xfer_count++;
+    packet.xfer_time += elapsed;
+    if (elapsed > packet.xfer_time_max)
+    {
+        packet.xfer_time_max = elapsed;
+    }
+#endif
+
+    /* The slave has data, or a staged packet is waiting */
+    rx_pending = (resp.slave_tx_buf > 0);
+    if (rx_pending || (tx_staged != RT_NULL))
     {
         return TRANSFER_DATA_CONTINUE;
     }
@@ -227,13 +508,39 @@ _cmderr:
     return TRANSFER_DATA_ERROR;
 }
 
-static int spi_wifi_transfer(struct rw007_spi *dev)
+/* rx_wait: how long to wait for an rx pool buffer when none is free */
+static int spi_wifi_transfer(struct rw007_spi *dev, rt_int32_t rx_wait)
 {
     static uint16_t cmd_seq = 0;
     int result = TRANSFER_DATA_SUCCESS;
     uint8_t * rx_buffer = rt_mp_alloc(&dev->spi_rx_mp, RT_WAITING_NO);
     int32_t retry;
 
+    if (rx_buffer == RT_NULL)
+    {
+#ifdef WLAN_DEV_MONITOR
+        packet.rx_pool_empty++;
+#endif
+        /* without a buffer MRDY stays clear and the slave holds its frame */
+        if (rx_wait != RT_WAITING_NO)
+        {
+            rx_buffer = rt_mp_alloc(&dev->spi_rx_mp, rx_wait);
+#ifdef WLAN_DEV_MONITOR
+            if (rx_buffer == RT_NULL)
+            {
+                packet.rx_pool_timeout++;
+            }
+#endif
+        }
+    }
+#ifdef WLAN_DEV_MONITOR
+    if (dev->spi_rx_mp.block_free_count < packet.rx_pool_min_free)
+    {
+        packet.rx_pool_min_free = dev->spi_rx_mp.block_free_count;
+    }
+    packet.rx_pool_hist[SPI_RX_POOL_SIZE - dev->spi_rx_mp.block_free_count]++;
+#endif
+
     /* Generate the transmission sequence number */
     cmd_seq++;
     if (cmd_seq >= 65534)
@@ -277,6 +584,65 @@ _err:
     return TRANSFER_DATA_ERROR;
 }
 
+/* hand a response to its waiter. With nobody waiting (the request timed
+ * out) the packet goes straight back to the rx pool instead of holding a
+ * block until the next call of the same command. Returns RT_TRUE when the
+ * packet was kept for a waiter. */
+static rt_bool_t wifi_resp_put(struct rw007_spi *dev, RW00x_CMD command, const struct spi_data_packet *data_packet)
+{
+    const struct spi_data_packet *old = data_packet;
+
+    rt_enter_critical();
+    if (dev->resp_waiting & RW00x_CMD_RESP_EVENT(command))
+    {
+        /* a duplicate response replaces the one not yet taken */
+        old = dev->resp[command];
+        dev->resp[command] = data_packet;
+    }
+    rt_exit_critical();
+
+    if (old)
+    {
+#ifdef WLAN_DEV_MONITOR
+        packet.resp_stale++;
+#endif
+        rt_mp_free((void *)old);
+    }
+    return (old != data_packet);
+}
+
+/* stop waiting for a command, returns the response packet if one arrived */
+static const struct spi_data_packet *wifi_resp_take(struct rw007_spi *dev, RW00x_CMD command)
+{
+    const struct spi_data_packet *data_packet;
+
+    rt_enter_critical();
+    dev->resp_waiting &= ~RW00x_CMD_RESP_EVENT(command);
+    data_packet = dev->resp[command];
+    dev->resp[command] = RT_NULL;
+    rt_exit_critical();
+    return data_packet;
+}
+
+/* hand a received ethernet frame to the wlan framework, which takes a pbuf
+ * when it forwards pbufs in both directions */
+static void wifi_report_eth(struct rt_wlan_device *wlan, const char *buffer, rt_uint32_t len)
+{
+#ifdef RT_WLAN_PROT_LWIP_PBUF_FORCE
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+
+    if (p == RT_NULL)
+    {
+        LOG_W("The wifi rx frame dropped, no pbuf\r");
+        return;
+    }
+    pbuf_take(p, buffer, len);
+    rt_wlan_dev_report_data(wlan, (void *)p, len);
+#else
+    rt_wlan_dev_report_data(wlan, (void *)buffer, len);
+#endif
+}
+
 static void wifi_data_process_thread_entry(void *parameter)
 {
     const struct spi_data_packet *data_packet = RT_NULL;
@@ -284,18 +650,20 @@ static void wifi_data_process_thread_entry(void *parameter)
 
     while(1)
     {
-        /* get the mempool memory for recv data package */
-        if(rt_mb_recv(&dev->spi_rx_mb, (rt_ubase_t *)&data_packet, RT_WAITING_FOREVER) == RT_EOK)
+        RW007_HEARTBEAT(RW007_THREAD_HANDLE);
+
+        /* get the mempool memory for recv data package, bounded wait keeps the heartbeat alive when idle */
+        if(rt_mb_recv(&dev->spi_rx_mb, (rt_ubase_t *)&data_packet, rt_tick_from_millisecond(RW007_HEARTBEAT_MS)) == RT_EOK)
         {
             if (data_packet->data_type == DATA_TYPE_STA_ETH_DATA)
             {
                 /* Ethernet package from station device */
-                rt_wlan_dev_report_data(wifi_sta.wlan, (void *)data_packet->buffer, data_packet->data_len);
+                wifi_report_eth(wifi_sta.wlan, data_packet->buffer, data_packet->data_len);
             }
             else if (data_packet->data_type == DATA_TYPE_AP_ETH_DATA)
             {
                 /* Ethernet package from ap device */
-                rt_wlan_dev_report_data(wifi_ap.wlan, (void *)data_packet->buffer, data_packet->data_len);
+                wifi_report_eth(wifi_ap.wlan, data_packet->buffer, data_packet->data_len);
             }
             else if (data_packet->data_type == DATA_TYPE_PROMISC_ETH_DATA)
             {
@@ -339,49 +707,76 @@ static void wifi_data_process_thread_entry(void *parameter)
                 struct rw007_resp * resp = (struct rw007_resp *)data_packet->buffer;
                 if(resp->cmd < RW00x_CMD_MAX_NUM)
                 {
-                    if(dev->resp[resp->cmd])
+                    /* hand the packet to the response slot, the waiter frees it */
+                    if (wifi_resp_put(dev, (RW00x_CMD)resp->cmd, data_packet))
                     {
-                        rt_free(dev->resp[resp->cmd]);
-                    }
-
-                    /* stash response result */
-                    dev->resp[resp->cmd] = rt_malloc(MAX_SPI_PACKET_SIZE);
-                    if(dev->resp[resp->cmd])
-                    {
-                        rt_memcpy(dev->resp[resp->cmd], resp, MAX_SPI_PACKET_SIZE);
-
                         /* notify response arrived */
                         rt_event_send(dev->rw007_cmd_event, RW00x_CMD_RESP_EVENT(resp->cmd));
                     }
+                    data_packet = RT_NULL;
                 }
             }
             /* free recv mempool memory */
-            rt_mp_free((void *)data_packet);
+            if (data_packet)
+            {
+                rt_mp_free((void *)data_packet);
+            }
         }
     }
 }
 
+#ifdef WLAN_DEV_MONITOR
+static void rw007_burst_note(rt_uint32_t burst)
+{
+    rt_uint32_t bucket = 0;
+
+    while ((bucket < RX_BURST_BUCKETS - 1) && (burst > (1UL << bucket)))
+    {
+        bucket++;
+    }
+    packet.rx_burst_hist[bucket]++;
+    packet.rx_bursts++;
+    packet.rx_burst_xfers += burst;
+    if (burst > packet.rx_burst_max)
+    {
+        packet.rx_burst_max = burst;
+    }
+}
+#endif
+
 static void spi_wifi_data_thread_entry(void *parameter)
 {
     rt_bool_t empty_read = RT_TRUE;
     rt_uint32_t event;
+    rt_uint32_t burst;
+    const rt_int32_t rx_wait = rt_tick_from_millisecond(RW007_RX_POOL_WAIT_MS);
     int state;
     
     while (1)
     {
-        /* receive first event */
+        RW007_HEARTBEAT(RW007_THREAD_XFER);
+
+        /* receive first event, timeout only refreshes the heartbeat */
         if (rt_event_recv(&spi_wifi_data_event,
                           RW007_MASTER_DATA|
                           RW007_SLAVE_INT,
                           RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
-                          RT_WAITING_FOREVER,
+                          rt_tick_from_millisecond(RW007_HEARTBEAT_MS),
                           &event) != RT_EOK)
                           
         {
             continue;
         }
-        /* transfer */
-        state = spi_wifi_transfer(&rw007_spi);
+        /* transfer, then drain what the slave still holds in the same wakeup */
+        burst = 0;
+        do
+        {
+            state = spi_wifi_transfer(&rw007_spi, rx_pending ? rx_wait : RT_WAITING_NO);
+            burst++;
+        } while ((state == TRANSFER_DATA_CONTINUE) && (burst < RW007_RX_BURST_MAX));
+#ifdef WLAN_DEV_MONITOR
+        rw007_burst_note(burst);
+#endif
 
         /* Try reading again */
         if(state == TRANSFER_DATA_CONTINUE)
@@ -439,56 +834,70 @@ rt_inline void spi_send_cmd(struct rw007_spi * hspi, RW00x_CMD COMMAND, void * b
     rt_event_send(&spi_wifi_data_event, RW007_MASTER_DATA);
 }
 
-rt_inline rt_err_t spi_set_data(struct rt_wlan_device *wlan, RW00x_CMD COMMAND, void * buffer, rt_uint32_t len)
+/* send a command and take its response packet out of the slot, the caller
+ * frees it with rt_mp_free. Returns RT_NULL on timeout. */
+static const struct spi_data_packet *spi_cmd_request(struct rw007_spi * hspi, RW00x_CMD COMMAND, void * buffer, rt_uint32_t len)
 {
-    struct rw007_spi * hspi = wifi_get_dev_by_wlan(wlan)->hspi;
     rt_uint32_t result_event;
-    rt_err_t result = RT_EOK;
+
+    /* clear an event left by a response that raced an earlier timeout,
+     * then register as the waiter before the command goes out */
+    rt_event_recv(hspi->rw007_cmd_event,
+                  RW00x_CMD_RESP_EVENT(COMMAND),
+                  RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR,
+                  RT_WAITING_NO,
+                  &result_event);
+    rt_enter_critical();
+    hspi->resp_waiting |= RW00x_CMD_RESP_EVENT(COMMAND);
+    rt_exit_critical();
+
     spi_send_cmd(hspi, COMMAND, buffer, len);
-    if(rt_event_recv(hspi->rw007_cmd_event, 
-                    RW00x_CMD_RESP_EVENT(COMMAND), 
-                    RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, 
-                    rt_tick_from_millisecond(10000),
-                    &result_event) != RT_EOK)
+    rt_event_recv(hspi->rw007_cmd_event,
+                  RW00x_CMD_RESP_EVENT(COMMAND),
+                  RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR,
+                  rt_tick_from_millisecond(10000),
+                  &result_event);
+
+    /* a response arriving after this is freed by the dispatch thread */
+    return wifi_resp_take(hspi, COMMAND);
+}
+
+rt_inline rt_err_t spi_set_data(struct rt_wlan_device *wlan, RW00x_CMD COMMAND, void * buffer, rt_uint32_t len)
+{
+    struct rw007_spi * hspi = wifi_get_dev_by_wlan(wlan)->hspi;
+    const struct spi_data_packet *data_packet;
+    rt_err_t result;
+
+    data_packet = spi_cmd_request(hspi, COMMAND, buffer, len);
+    if(data_packet == RT_NULL)
     {
         return -RT_ETIMEOUT;
     }
 
-    if(hspi->resp[COMMAND])
-    {
-        result = hspi->resp[COMMAND]->result;
-        rt_free(hspi->resp[COMMAND]);
-        hspi->resp[COMMAND] = RT_NULL;
-        return result;
-    }
-    return RT_EOK;
+    result = ((struct rw007_resp *)data_packet->buffer)->result;
+    rt_mp_free((void *)data_packet);
+    return result;
 }
 
 rt_inline rt_err_t spi_get_data(struct rt_wlan_device *wlan, RW00x_CMD COMMAND, void * buffer, rt_uint32_t *len)
 {
     struct rw007_spi * hspi = wifi_get_dev_by_wlan(wlan)->hspi;
-    rt_uint32_t result_event;
-    rt_err_t result = RT_EOK;
-    spi_send_cmd(hspi, COMMAND, RT_NULL, 0);
-    if(rt_event_recv(hspi->rw007_cmd_event, 
-                    RW00x_CMD_RESP_EVENT(COMMAND), 
-                    RT_EVENT_FLAG_AND | RT_EVENT_FLAG_CLEAR, 
-                    rt_tick_from_millisecond(10000),
-                    &result_event) != RT_EOK)
+    const struct spi_data_packet *data_packet;
+    struct rw007_resp *resp;
+    rt_err_t result;
+
+    data_packet = spi_cmd_request(hspi, COMMAND, RT_NULL, 0);
+    if(data_packet == RT_NULL)
     {
         return -RT_ETIMEOUT;
     }
 
-    if(hspi->resp[COMMAND])
-    {
-        *len = hspi->resp[COMMAND]->len;
-        rt_memcpy(buffer, &hspi->resp[COMMAND]->value, hspi->resp[COMMAND]->len);
-        result = hspi->resp[COMMAND]->result;
-        rt_free(hspi->resp[COMMAND]);
-        hspi->resp[COMMAND] = RT_NULL;
-        return result;
-    }
-    return RT_EOK;
+    resp = (struct rw007_resp *)data_packet->buffer;
+    *len = resp->len;
+    rt_memcpy(buffer, &resp->value, resp->len);
+    result = resp->result;
+    rt_mp_free((void *)data_packet);
+    return result;
 }
 
 rt_err_t rw007_sn_get(char sn[24])
@@ -650,6 +1059,52 @@ static rt_err_t wlan_get_mac(struct rt_wlan_device *wlan, rt_uint8_t mac[])
     return spi_get_data(wlan, RW00x_CMD_AP_MAC_GET, mac, &size_of_data);
 }
 
+/* take a tx block for an ethernet frame: wait until one is free, or with
+ * RW007_TX_DROP_ON_FULL give up at once so lwIP is never held up here */
+static void *wifi_tx_alloc(struct rt_mempool *mp)
+{
+    void *block = rt_mp_alloc(mp, RT_WAITING_NO);
+#if defined(WLAN_DEV_MONITOR) && !defined(RW007_TX_DROP_ON_FULL)
+    rt_uint32_t start, elapsed;
+#endif
+
+    if (block != RT_NULL)
+    {
+        return block;
+    }
+
+#ifdef RW007_TX_DROP_ON_FULL
+#ifdef WLAN_DEV_MONITOR
+    packet.tx_dropped++;
+#endif
+#else
+#ifdef WLAN_DEV_MONITOR
+    start = RW007_XFER_CLOCK();
+#endif
+    block = rt_mp_alloc(mp, RT_WAITING_FOREVER);
+#ifdef WLAN_DEV_MONITOR
+    elapsed = RW007_XFER_CLOCK() - start;
+    packet.tx_blocked++;
+    packet.tx_blocked_time += elapsed;
+    if (elapsed > packet.tx_blocked_max)
+    {
+        packet.tx_blocked_max = elapsed;
+    }
+#endif
+#endif /* RW007_TX_DROP_ON_FULL */
+    return block;
+}
+
+/* queue a tx block and wake the transfer thread */
+static void wifi_tx_queue(struct rw007_spi *hspi, const void *block)
+{
+    rt_mb_send(&hspi->spi_tx_mb, (rt_ubase_t)block);
+#ifdef WLAN_DEV_MONITOR
+    packet.tx_queue_hist[hspi->spi_tx_mb.entry]++;
+#endif
+    rt_event_send(&spi_wifi_data_event, RW007_MASTER_DATA);
+}
+
 static int wlan_send(struct rt_wlan_device *wlan, void *buff, int len)
 {
     struct rw007_spi * hspi = wifi_get_dev_by_wlan(wlan)->hspi;
@@ -660,7 +1115,41 @@ static int wlan_send(struct rt_wlan_device *wlan, void *buff, int len)
         return -1;
     }
 
-    data_packet = rt_mp_alloc(&hspi->spi_tx_mp, RT_WAITING_FOREVER);
+#ifdef RW007_TX_ZERO_COPY
+    {
+        /* buff is the pbuf chain: queue a reference, the frame is gathered
+         * from its segments during the data phase */
+        struct pbuf *p = (struct pbuf *)buff;
+        struct spi_data_pbuf *data_pbuf;
+
+        if ((len <= 0) || (len > SPI_MAX_DATA_LEN))
+        {
+            return -1;
+        }
+
+        data_pbuf = wifi_tx_alloc(&hspi->spi_tx_pbuf_mp);
+        if (data_pbuf == RT_NULL)
+        {
+            return -1;
+        }
+        data_pbuf->data_type = (wlan == wifi_sta.wlan) ? DATA_TYPE_STA_ETH_DATA : DATA_TYPE_AP_ETH_DATA;
+        data_pbuf->data_len = len;
+        data_pbuf->p = p;
+        pbuf_ref(p);
+
+#ifdef WLAN_DEV_MONITOR
+        packet.tx_zero_copy++;
+#endif
+        wifi_tx_queue(hspi, data_pbuf);
+        return len;
+    }
+#endif
+
+    data_packet = wifi_tx_alloc(&hspi->spi_tx_mp);
+    if (data_packet == RT_NULL)
+    {
+        return -1;
+    }
 
     if (wlan == wifi_sta.wlan)
     {
@@ -672,10 +1161,14 @@ static int wlan_send(struct rt_wlan_device *wlan, void *buff, int len)
     }
     data_packet->data_len = len;
 
+#ifdef RT_WLAN_PROT_LWIP_PBUF_FORCE
+    /* buff is the pbuf chain, gathered into the packet now */
+    pbuf_copy_partial((struct pbuf *)buff, data_packet->buffer, len, 0);
+#else
     rt_memcpy(data_packet->buffer, buff, len);
+#endif
 
-    rt_mb_send(&hspi->spi_tx_mb, (rt_ubase_t)data_packet);
-    rt_event_send(&spi_wifi_data_event, RW007_MASTER_DATA);
+    wifi_tx_queue(hspi, data_packet);
     return len;
 }
 
@@ -746,8 +1239,17 @@ rt_err_t rt_hw_wifi_init(const char *spi_device_name)
     rt_mb_init(&rw007_spi.spi_tx_mb,
                "spi_tx",
                &rw007_spi.spi_tx_mb_pool[0],
-               SPI_TX_POOL_SIZE,
+               SPI_TX_MB_SIZE,
                RT_IPC_FLAG_PRIO);
+
+#ifdef RW007_TX_ZERO_COPY
+    /* init zero-copy tx descriptor mempool */
+    rt_mp_init(&rw007_spi.spi_tx_pbuf_mp,
+               "spi_txp",
+               &rw007_spi.spi_tx_pbuf_mempool[0],
+               sizeof(rw007_spi.spi_tx_pbuf_mempool),
+               sizeof(struct spi_data_pbuf));
+#endif
     
     /* init spi recv mempool */
     rt_mp_init(&rw007_spi.spi_rx_mp,
@@ -766,6 +1268,18 @@ rt_err_t rt_hw_wifi_init(const char *spi_device_name)
     /* init spi data notify event */
     rt_event_init(&spi_wifi_data_event, "wifi", RT_IPC_FLAG_FIFO);
 
+#ifdef RW007_USING_SPI_DMA
+    rt_sem_init(&spi_dma_sem, "wifi_dma", 0, RT_IPC_FLAG_FIFO);
+#endif
+
+#ifdef WLAN_DEV_MONITOR
+    packet.rx_pool_min_free = SPI_RX_POOL_SIZE;
+#ifdef RW007_XFER_CLOCK_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+#endif
+
     rw007_spi.rw007_cmd_event = rt_event_create("wifi_cmd", RT_IPC_FLAG_FIFO);
 
     /* register wlan device for ap */
@@ -830,8 +1344,22 @@ void spi_wifi_isr(int vector)
 }
 
 #ifdef WLAN_DEV_MONITOR
+/* the clock rate may be a variable (SystemCoreClock), so scale at run time */
+static rt_uint32_t rw007_clock_to_us(rt_uint64_t t)
+{
+    rt_uint32_t hz = RW007_XFER_CLOCK_HZ;
+
+    if (hz >= 1000000)
+    {
+        return (rt_uint32_t)(t / (hz / 1000000));
+    }
+    return (rt_uint32_t)(t * (1000000 / hz));
+}
+
 int rw007_dump(int argc, char **argv)
 {
+    int i;
+
     if (argc == 1)
     {
         goto __usage;
@@ -845,6 +1373,47 @@ int rw007_dump(int argc, char **argv)
         rt_kprintf("Retry count        : %d\n", packet.retry);
         rt_kprintf("Stage 1 error      : %d\n", packet.first_stage_err);
         rt_kprintf("Stage 2 error      : %d\n", packet.second_stage_err);
+        rt_kprintf("Transfers done     : %d\n", packet.xfer_count);
+        if (packet.xfer_count)
+        {
+            rt_kprintf("Transfer avg/max   : %d / %d us\n",
+                       rw007_clock_to_us(packet.xfer_time / packet.xfer_count),
+                       rw007_clock_to_us(packet.xfer_time_max));
+            rt_kprintf("Data phase avg     : %d us, %d bytes\n",
+                       rw007_clock_to_us(packet.data_time / packet.xfer_count),
+                       packet.data_bytes / packet.xfer_count);
+        }
+        rt_kprintf("DMA data phases    : %d\n", packet.dma_xfer);
+        rt_kprintf("DMA errors         : %d\n", packet.dma_err);
+        rt_kprintf("Tx staged in DMA   : %d\n", packet.tx_staged);
+        rt_kprintf("Tx zero-copy       : %d\n", packet.tx_zero_copy);
+        rt_kprintf("Stale responses    : %d\n", packet.resp_stale);
+        if (packet.rx_bursts)
+        {
+            rt_kprintf("Burst avg/max      : %d.%02d / %d transfers\n",
+                       packet.rx_burst_xfers / packet.rx_bursts,
+                       packet.rx_burst_xfers % packet.rx_bursts * 100 / packet.rx_bursts,
+                       packet.rx_burst_max);
+            rt_kprintf("Burst 1/2/3-4/5-8/9+ : %d / %d / %d / %d / %d\n",
+                       packet.rx_burst_hist[0], packet.rx_burst_hist[1], packet.rx_burst_hist[2],
+                       packet.rx_burst_hist[3], packet.rx_burst_hist[4]);
+        }
+        rt_kprintf("Rx pool size       : %d, min free %d\n", SPI_RX_POOL_SIZE, packet.rx_pool_min_free);
+        rt_kprintf("Rx pool empty      : %d, wait timeout %d\n", packet.rx_pool_empty, packet.rx_pool_timeout);
+        rt_kprintf("Rx buffers in use  :");
+        for (i = 0; i <= SPI_RX_POOL_SIZE; i++)
+        {
+            rt_kprintf(" %d:%d", i, packet.rx_pool_hist[i]);
+        }
+        rt_kprintf("\nTx queue depth     :");
+        for (i = 0; i <= SPI_TX_MB_SIZE; i++)
+        {
+            rt_kprintf(" %d:%d", i, packet.tx_queue_hist[i]);
+        }
+        rt_kprintf("\n");
+        rt_kprintf("Tx blocked         : %d, total %d us, max %d us\n", packet.tx_blocked,
+                   rw007_clock_to_us(packet.tx_blocked_time), rw007_clock_to_us(packet.tx_blocked_max));
+        rt_kprintf("Tx dropped         : %d\n", packet.tx_dropped);
     }
     else if (strcmp(argv[1], "-h") == 0)
     {
@@ -853,6 +1422,7 @@ int rw007_dump(int argc, char **argv)
     else if (strcmp(argv[1], "-c") == 0)
     {
         rt_memset(&packet, 0, sizeof(packet));
+        packet.rx_pool_min_free = SPI_RX_POOL_SIZE;
     }
     return 0;
 __usage:
@@ -16,6 +16,9 @@
 #define RT_USING_IDLE_HOOK
 #define RT_IDLE_HOOK_LIST_SIZE 4
 #define IDLE_THREAD_STACK_SIZE 1024
+#define RT_USING_TIMER_SOFT
+#define RT_TIMER_THREAD_PRIO 4
+#define RT_TIMER_THREAD_STACK_SIZE 1024
 
 /* kservice optimization */
 
@@ -111,6 +114,7 @@
 #define RT_WLAN_DEFAULT_PROT "lwip"
 #define RT_WLAN_PROT_LWIP_ENABLE
 #define RT_WLAN_PROT_LWIP_NAME "lwip"
+#define RT_WLAN_PROT_LWIP_PBUF_FORCE
 #define RT_WLAN_WORK_THREAD_ENABLE
 #define RT_WLAN_WORKQUEUE_THREAD_NAME "wlan"
 #define RT_WLAN_WORKQUEUE_THREAD_SIZE 2048
@@ -177,7 +181,7 @@
 #define RT_MEMP_NUM_NETCONN 8
 #define RT_LWIP_PBUF_NUM 16
 #define RT_LWIP_RAW_PCB_NUM 4
-#define RT_LWIP_UDP_PCB_NUM 4
+#define RT_LWIP_UDP_PCB_NUM 12
 #define RT_LWIP_TCP_PCB_NUM 4
 #define RT_LWIP_TCP_SEG_NUM 40
 #define RT_LWIP_TCP_SND_BUF 8196
@@ -195,7 +199,7 @@
 #define LWIP_SO_SNDTIMEO 1
 #define LWIP_SO_RCVBUF 1
 #define LWIP_SO_LINGER 0
-#define LWIP_NETIF_LOOPBACK 0
+#define LWIP_NETIF_LOOPBACK 1
 #define RT_LWIP_USING_PING
 /* end of Network */
 
@@ -242,6 +246,8 @@
 #define RW007_BOOT1_PIN 90
 #define RW007_INT_BUSY_PIN 107
 #define RW007_RST_PIN 111
+#define RW007_USING_SPI_DMA
+#define WLAN_DEV_MONITOR
 
 /* CYW43012 WiFi */
 
@@ -456,8 +462,11 @@
 #define BSP_USING_PWM14_CH1
 #define BSP_USING_SPI
 #define BSP_USING_SPI2
+#define BSP_SPI2_TX_USING_DMA
+#define BSP_SPI2_RX_USING_DMA
 #define BSP_USING_EXT_FMC_IO
 #define BSP_USING_FMC
+#define BSP_USING_WDT
 /* end of On-chip Peripheral Drivers */
 
 /* Board extended module Drivers */
@@ -465,4 +474,34 @@
 /* end of Board extended module Drivers */
 /* end of Hardware Drivers Config */
 
+/* Seat Receiver Config */
+
+#define SEAT_DB_MAX_SEATS 64
+#define SEAT_ID_LIMIT 256
+#define SEAT_ZONE_SIZE 32
+#define SEAT_INGEST_POOL_SIZE 2
+#define SEAT_TELEMETRY_DEPTH 32
+#define SEAT_CLAIM_TIMEOUT_SEC 1800
+#define SEAT_CLAIM_WHEEL_TICK_MS 1000
+#define SEAT_CLAIM_WHEEL_SLOTS 64
+#define SEAT_LCD_TILE_PIXELS 2048
+#define SEAT_LABEL_CACHE_SIZE 7168
+#define SEAT_UI_PAGE_INTERVAL_MS 5000
+#define SEAT_UI_PAGE_CELLS_PER_STEP 8
+#define SOFT_WDT_MAX_INSTANCES 2
+#define SEAT_CRASH_TRANSITIONS 8
+#define SOFT_WDT_MAX_CHANNELS 8
+#define SEAT_INGEST_PORT 8080
+#define SEAT_INGEST_SOURCES 8
+#define SEAT_LOADGEN_MAX_BOARDS 8
+#define SEAT_TRACE_RAM_SIZE 4096
+
+/* RW007 WiFi driver tuning */
+
+#define SPI_TX_POOL_SIZE 4
+#define SPI_RX_POOL_SIZE 4
+#define SPI_TX_PBUF_POOL_SIZE 8
+/* end of RW007 WiFi driver tuning */
+/* end of Seat Receiver Config */
+
 #endif
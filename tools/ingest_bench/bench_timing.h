@@ -0,0 +1,55 @@
+#ifndef __BENCH_TIMING_H__
+#define __BENCH_TIMING_H__
+
+/* 主机基准工具共用的耗时统计，ingest_bench与trace_replay按相同格式输出便于对照 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <rtthread.h>
+
+typedef struct {
+    rt_uint32_t count;
+    rt_uint32_t capacity;
+    rt_uint32_t *samples;       // 纳秒
+    rt_uint64_t total;
+} bench_timing_t;
+
+static rt_uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void bench_timing_add(bench_timing_t *t, rt_uint64_t ns)
+{
+    if (t->count == t->capacity) {
+        t->capacity = t->capacity ? t->capacity * 2 : 4096;
+        t->samples = realloc(t->samples, t->capacity * sizeof(*t->samples));
+    }
+    t->samples[t->count++] = ns > 0xFFFFFFFFu ? 0xFFFFFFFFu : (rt_uint32_t)ns;
+    t->total += ns;
+}
+
+static int bench_cmp_u32(const void *a, const void *b)
+{
+    rt_uint32_t x = *(const rt_uint32_t *)a, y = *(const rt_uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/* 输出平均、中位、p99与最大值（微秒） */
+static void bench_timing_print(const char *label, bench_timing_t *t)
+{
+    if (t->count == 0) {
+        return;
+    }
+    qsort(t->samples, t->count, sizeof(*t->samples), bench_cmp_u32);
+    printf("%-9s: avg %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us\n", label,
+           t->total / 1000.0 / t->count,
+           t->samples[t->count / 2] / 1000.0,
+           t->samples[(rt_uint64_t)t->count * 99 / 100] / 1000.0,
+           t->samples[t->count - 1] / 1000.0);
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * 座位数据库基准，在主机上用clock_gettime计时，数据库是本进程内的一份，不碰目标板状态：
+ *   查询：位图扫描与逐座位线性遍历的对比，两种方法都取前16个空闲座位并统计空闲总数；
+ *   更新：一帧记录走db_batch提交与逐座位db_update_seat_status的对比。
+ *
+ * 编译：在tools/ingest_bench目录下执行 make db_bench（见Makefile）
+ *
+ * 用法：
+ *   db_bench [-n 座位数] [-r 轮数] [-f 空闲比例%] [-S 随机种子] [-F 每帧座位数] [-R 帧数]
+ *   查询默认4096个座位，约一成空闲且随机分布；更新默认每帧40个座位、200帧。
+ *   逐座位路径每条记录打一行日志，测量时把stderr重定向到/dev/null。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <rtthread.h>
+
+#include "seat_bitmap.h"
+#include "seat_db.h"
+#include "claim_policy.h"
+#include "bench_timing.h"
+
+#define QUERY_IDS   16
+
+/* 同一组帧分别走逐座位更新和批量提交，统计每帧耗时 */
+static int bench_update(rt_uint32_t frame_seats, rt_uint32_t frames)
+{
+    bench_timing_t single = {0}, batched = {0};
+    seat_record_t *records;
+    seat_batch_t batch;
+
+    records = malloc(sizeof(seat_record_t) * frame_seats);
+    if (!records) {
+        fprintf(stderr, "no memory\n");
+        return -1;
+    }
+
+    for (rt_uint32_t r = 0; r < frames; r++) {
+        rt_uint64_t t0 = bench_now_ns();
+
+        for (rt_uint16_t i = 0; i < frame_seats; i++) {
+            db_update_seat_status(i + 1, (SeatStatus)((i + r) % SEAT_STATUS_NUM));
+        }
+        bench_timing_add(&single, bench_now_ns() - t0);
+
+        t0 = bench_now_ns();
+        db_batch_begin(&batch, records, frame_seats);
+        for (rt_uint16_t i = 0; i < frame_seats; i++) {
+            db_batch_apply(&batch, i + 1, (SeatStatus)((i + r + 1) % SEAT_STATUS_NUM));
+        }
+        db_batch_commit(&batch);
+        bench_timing_add(&batched, bench_now_ns() - t0);
+    }
+
+    printf("Frames   : %u seats x %u frames\n", frame_seats, frames);
+    bench_timing_print("Per-seat", &single);
+    bench_timing_print("Batch", &batched);
+
+    free(records);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    rt_uint32_t seats = 4096, rounds = 1000, free_pct = 10, seed = 1;
+    rt_uint32_t frame_seats = 40, frames = 200;
+    bench_timing_t linear = {0}, bitmap = {0};
+    rt_uint16_t ids[QUERY_IDS];
+    volatile rt_uint32_t sink = 0;
+    rt_uint32_t free_count = 0;
+    rt_uint8_t *status;
+    rt_uint32_t *map;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:f:S:F:R:")) != -1) {
+        switch (opt) {
+        case 'n': seats = atoi(optarg); break;
+        case 'r': rounds = atoi(optarg); break;
+        case 'f': free_pct = atoi(optarg); break;
+        case 'S': seed = atoi(optarg); break;
+        case 'F': frame_seats = atoi(optarg); break;
+        case 'R': frames = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-n seats] [-r rounds] [-f free%%] [-S seed] "
+                    "[-F frame_seats] [-R frames]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (seats == 0 || seats > 65536 || rounds == 0 || free_pct > 100 ||
+        frame_seats == 0 || frame_seats > SEAT_DB_MAX_SEATS || frames == 0) {
+        fprintf(stderr, "invalid parameters\n");
+        return 1;
+    }
+
+    status = malloc(seats);
+    map = calloc(SEAT_BITMAP_WORDS(seats), sizeof(rt_uint32_t));
+    if (!status || !map) {
+        fprintf(stderr, "no memory\n");
+        return 1;
+    }
+
+    srand(seed);
+    for (rt_uint32_t i = 0; i < seats; i++) {
+        status[i] = ((rt_uint32_t)rand() % 100 < free_pct) ? SEAT_AVAILABLE : SEAT_OCCUPIED;
+        if (status[i] == SEAT_AVAILABLE) {
+            seat_bitmap_set(map, i);
+            free_count++;
+        }
+    }
+
+    for (rt_uint32_t r = 0; r < rounds; r++) {
+        rt_uint64_t t0 = bench_now_ns();
+        rt_uint32_t n = 0, count = 0;
+
+        for (rt_uint32_t i = 0; i < seats; i++) {
+            if (status[i] == SEAT_AVAILABLE) {
+                if (n < QUERY_IDS) {
+                    ids[n++] = i;
+                }
+                count++;
+            }
+        }
+        sink += count + ids[0];
+        bench_timing_add(&linear, bench_now_ns() - t0);
+
+        t0 = bench_now_ns();
+        seat_bitmap_find_first_n(map, 0, seats, ids, QUERY_IDS);
+        sink += seat_bitmap_count_range(map, 0, seats) + ids[0];
+        bench_timing_add(&bitmap, bench_now_ns() - t0);
+    }
+
+    printf("Seats    : %u, %u free, %u rounds\n", seats, free_count, rounds);
+    bench_timing_print("Linear", &linear);
+    bench_timing_print("Bitmap", &bitmap);
+
+    free(status);
+    free(map);
+
+    db_init();
+    claim_policy_init();
+    return bench_update(frame_seats, frames) ? 1 : 0;
+}
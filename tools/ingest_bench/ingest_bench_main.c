@@ -0,0 +1,165 @@
+/*
+ * UDP接收吞吐基准：在Linux上用udp_loadgen模拟多块识别板，经127.0.0.1向接收端口发送
+ * 真实数据报，接收端调用与目标板相同的seat_ingest解析并写入数据库，
+ * 输出计划速率与实际速率、各板丢包及单个数据报的入库耗时。
+ *
+ * 编译：在tools/ingest_bench目录下执行 make ingest_bench（见Makefile）
+ *
+ * 用法：
+ *   ingest_bench [-b 板数] [-r 每板每秒数据报] [-B 突发长度] [-n 每报记录数]
+ *                [-t 秒] [-p 端口] [-s 接收缓冲字节] [-w 追踪文件]
+ *   数据库日志输出到stderr，测量时可重定向到/dev/null。
+ *   -s 缩小内核接收缓冲，模拟目标板上有限的pbuf，观察突发造成的丢包。
+ *   -w 把接收到的数据报写成追踪文件，可用trace_replay回放。
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <rtthread.h>
+
+#include "seat_db.h"
+#include "claim_policy.h"
+#include "seat_ingest.h"
+#include "seat_trace.h"
+#include "udp_loadgen.h"
+#include "wifi_module.h"
+#include "bench_timing.h"
+
+SeatData g_seat_data;
+
+static void file_sink(const void *data, rt_size_t len, void *arg)
+{
+    fwrite(data, 1, len, (FILE *)arg);
+}
+
+static int open_receiver(rt_uint16_t port, int rcvbuf)
+{
+    struct sockaddr_in addr;
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (sock < 0) {
+        return -1;
+    }
+    if (rcvbuf > 0) {
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+/* 取完接收队列中已有的数据报，与目标板接收线程的处理路径一致 */
+static void drain(int sock, bench_timing_t *timing)
+{
+    struct sockaddr_in from;
+    socklen_t from_len;
+    char buf[384];
+
+    while (1) {
+        from_len = sizeof(from);
+        int len = recvfrom(sock, buf, sizeof(buf) - 1, MSG_DONTWAIT,
+                           (struct sockaddr *)&from, &from_len);
+        if (len <= 0) {
+            return;
+        }
+        buf[len] = '\0';
+
+        rt_uint64_t t = bench_now_ns();
+        seat_ingest_datagram(buf, from.sin_addr.s_addr, ntohs(from.sin_port));
+        bench_timing_add(timing, bench_now_ns() - t);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    udp_loadgen_config_t cfg = { 4, 1, 100, 1, SEAT_INGEST_PORT, 0 };
+    static udp_loadgen_t gen;
+    bench_timing_t timing = { 0 };
+    seat_ingest_stats_t stats;
+    const char *trace_path = RT_NULL;
+    FILE *trace_file = RT_NULL;
+    int seconds = 5, rcvbuf = 0, opt, sock;
+
+    while ((opt = getopt(argc, argv, "b:r:B:n:t:p:s:w:")) != -1) {
+        switch (opt) {
+        case 'b': cfg.boards = atoi(optarg); break;
+        case 'r': cfg.rate = atoi(optarg); break;
+        case 'B': cfg.burst = atoi(optarg); break;
+        case 'n': cfg.records = atoi(optarg); break;
+        case 't': seconds = atoi(optarg); break;
+        case 'p': cfg.dest_port = atoi(optarg); break;
+        case 's': rcvbuf = atoi(optarg); break;
+        case 'w': trace_path = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-b boards] [-r rate] [-B burst] [-n records] "
+                            "[-t seconds] [-p port] [-s rcvbuf] [-w trace]\n", argv[0]);
+            return 2;
+        }
+    }
+    cfg.dest_addr = htonl(INADDR_LOOPBACK);
+
+    db_init();
+    claim_policy_init();
+    seat_trace_init();
+    seat_ingest_init();
+
+    if (trace_path) {
+        trace_file = fopen(trace_path, "wb");
+        if (trace_file == RT_NULL) {
+            perror(trace_path);
+            return 1;
+        }
+        seat_trace_start_stream(file_sink, trace_file);
+    }
+
+    sock = open_receiver(cfg.dest_port, rcvbuf);
+    if (sock < 0) {
+        perror("receiver bind");
+        return 1;
+    }
+    if (udp_loadgen_setup(&gen, &cfg) != RT_EOK) {
+        fprintf(stderr, "invalid load configuration\n");
+        return 1;
+    }
+
+    rt_tick_t end = rt_tick_get() + seconds * RT_TICK_PER_SECOND;
+    while ((rt_int32_t)(end - rt_tick_get()) > 0) {
+        rt_int32_t wait = udp_loadgen_poll(&gen);
+        struct pollfd pfd = { sock, POLLIN, 0 };
+
+        /* 等待到下一次突发到期，期间有数据即处理 */
+        if (poll(&pfd, 1, wait) > 0) {
+            drain(sock, &timing);
+        }
+    }
+
+    /* 停止发送后留出时间取完在途数据报 */
+    udp_loadgen_close(&gen);
+    rt_thread_mdelay(50);
+    drain(sock, &timing);
+    close(sock);
+
+    if (trace_file) {
+        seat_trace_stop();
+        fclose(trace_file);
+    }
+
+    udp_loadgen_report(&gen);
+
+    seat_ingest_get_stats(&stats);
+    printf("Ingested : %u datagrams, %u records, %u rejected\n",
+           stats.datagrams, stats.records, stats.rejected);
+    bench_timing_print("Ingest", &timing);
+    return 0;
+}
@@ -0,0 +1,276 @@
+/*
+ * 场景模拟器：用seat_scenario按场景表生成一整天的识别板数据报，经seat_ingest写入数据库，
+ * 以虚拟时钟推进占座超时时间轮与网格视图刷新，几秒内跑完一天。
+ * 输出每小时的座位分布、入库耗时、占座超时、掉线造成的失联座位与界面刷新耗时。
+ *
+ * 编译：在tools/ingest_bench目录下执行 make scenario_sim（见Makefile）
+ *
+ * 用法：
+ *   scenario_sim [-f 场景文件] [-n 座位数] [-s 步长ms] [-r 补报周期s] [-u 刷新周期ms]
+ *                [-L 失联阈值s] [-S 随机种子] [-w 追踪文件]
+ *   场景文件每行一条事件，格式见seat_scenario_parse_line，未指定时使用内置的一天。
+ *   -u 0关闭界面刷新；-w 同时录制追踪文件，可用trace_replay按实时节奏回放。
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <rtthread.h>
+#include <drv_lcd.h>
+
+#include "seat_db.h"
+#include "claim_policy.h"
+#include "seat_ingest.h"
+#include "seat_trace.h"
+#include "seat_scenario.h"
+#include "ui_grid.h"
+#include "ui_perf.h"
+#include "lcd_tile.h"
+#include "label_cache.h"
+#include "lcd_colors.h"
+#include "wifi_module.h"
+#include "bench_timing.h"
+
+SeatData g_seat_data;
+
+/* 模拟识别板的源端口：板号加此基数 */
+#define SIM_PORT_BASE   5000
+
+static seat_scn_event_t file_events[SEAT_SCN_MAX_EVENTS];
+static bench_timing_t ingest_timing, ui_timing;
+
+static void emit(char *datagram, rt_uint16_t board, void *arg)
+{
+    rt_uint64_t t = bench_now_ns();
+
+    seat_ingest_datagram(datagram, htonl(INADDR_LOOPBACK), SIM_PORT_BASE + board);
+    bench_timing_add(&ingest_timing, bench_now_ns() - t);
+}
+
+static void file_sink(const void *data, rt_size_t len, void *arg)
+{
+    fwrite(data, 1, len, (FILE *)arg);
+}
+
+static int load_scenario(const char *path, seat_scenario_t *scn)
+{
+    FILE *fp = fopen(path, "r");
+    char line[128];
+    int lineno = 0;
+
+    if (fp == RT_NULL) {
+        perror(path);
+        return -1;
+    }
+
+    rt_memset(scn, 0, sizeof(*scn));
+    scn->events = file_events;
+    while (fgets(line, sizeof(line), fp)) {
+        seat_scn_event_t *ev = &file_events[scn->event_count];
+        rt_err_t err;
+
+        lineno++;
+        if (scn->event_count == SEAT_SCN_MAX_EVENTS) {
+            fprintf(stderr, "%s:%d: too many events\n", path, lineno);
+            break;
+        }
+        err = seat_scenario_parse_line(line, ev);
+        if (err == -RT_EEMPTY) {
+            continue;
+        }
+        if (err != RT_EOK) {
+            fprintf(stderr, "%s:%d: bad event: %s", path, lineno, line);
+            fclose(fp);
+            return -1;
+        }
+        if (scn->event_count > 0 && ev->at < file_events[scn->event_count - 1].at) {
+            fprintf(stderr, "%s:%d: events must be in time order\n", path, lineno);
+            fclose(fp);
+            return -1;
+        }
+        scn->event_count++;
+    }
+    fclose(fp);
+
+    if (scn->event_count == 0) {
+        fprintf(stderr, "%s: no events\n", path);
+        return -1;
+    }
+    /* 从第一条事件所在整点开始，到最后一个窗口结束后一小时 */
+    scn->begin = file_events[0].at / 3600 * 3600;
+    scn->end = file_events[scn->event_count - 1].at + file_events[scn->event_count - 1].window + 3600;
+    return 0;
+}
+
+typedef struct {
+    rt_uint16_t count[SEAT_STATUS_NUM];
+    rt_uint16_t expired;        // 带占座超时标志
+    rt_uint16_t stale;          // 超过阈值未收到上报
+} occupancy_t;
+
+static void sample(occupancy_t *o, rt_tick_t now, rt_tick_t stale_ticks)
+{
+    rt_memset(o, 0, sizeof(*o));
+    rt_mutex_take(seat_db.lock, RT_WAITING_FOREVER);
+    for (rt_uint16_t i = 0; i < seat_db.count; i++) {
+        const SeatInfo *seat = &seat_db.seats[i];
+
+        o->count[seat->status]++;
+        if (seat->flags & SEAT_FLAG_CLAIM_EXPIRED) {
+            o->expired++;
+        }
+        if (now - seat->update_tick > stale_ticks) {
+            o->stale++;
+        }
+    }
+    rt_mutex_release(seat_db.lock);
+}
+
+int main(int argc, char **argv)
+{
+    static seat_scenario_t file_scn;
+    const seat_scenario_t *scn = &seat_scenario_library_day;
+    rt_uint32_t step_ms = 100, refresh_s = 30, ui_ms = 1000, liveness_s = 90, seed = 1;
+    rt_uint16_t seats = 64;
+    const char *trace_path = RT_NULL;
+    FILE *trace_file = RT_NULL;
+    seat_ingest_stats_t ingest;
+    seat_scn_stats_t scn_stats;
+    claim_policy_stats_t claim;
+    occupancy_t occ;
+    rt_uint16_t max_stale = 0;
+    rt_uint32_t max_stale_at = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:n:s:r:u:L:S:w:")) != -1) {
+        switch (opt) {
+        case 'f':
+            if (load_scenario(optarg, &file_scn) != 0) {
+                return 1;
+            }
+            scn = &file_scn;
+            break;
+        case 'n': seats = atoi(optarg); break;
+        case 's': step_ms = atoi(optarg); break;
+        case 'r': refresh_s = atoi(optarg); break;
+        case 'u': ui_ms = atoi(optarg); break;
+        case 'L': liveness_s = atoi(optarg); break;
+        case 'S': seed = atoi(optarg); break;
+        case 'w': trace_path = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-f scenario] [-n seats] [-s step_ms] [-r refresh_s] "
+                            "[-u ui_ms] [-L liveness_s] [-S seed] [-w trace]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (step_ms == 0) {
+        step_ms = 1;
+    }
+
+    /* 虚拟时钟从当天的开始时刻起算，数据库与追踪记录中的滴答即场景时间 */
+    rt_tick_t base = scn->begin * RT_TICK_PER_SECOND;
+    rt_host_set_tick(base);
+
+    db_init();
+    claim_policy_init();
+    seat_trace_init();
+    seat_ingest_init();
+    if (ui_ms) {
+        lcd_tile_init(&lcd_tile_sync_backend);
+        label_cache_init();
+        ui_perf_init();
+        lcd_clear(WHITE);
+    }
+    if (trace_path) {
+        trace_file = fopen(trace_path, "wb");
+        if (trace_file == RT_NULL) {
+            perror(trace_path);
+            return 1;
+        }
+        seat_trace_start_stream(file_sink, trace_file);
+    }
+
+    if (seat_scenario_init(scn, seats, refresh_s, seed, emit, RT_NULL) != RT_EOK) {
+        fprintf(stderr, "invalid scenario or seat count (max %d)\n", SEAT_SCN_MAX_SEATS);
+        return 1;
+    }
+
+    printf("%-5s %5s %5s %5s %7s %5s\n", "time", "free", "used", "claim", "expired", "stale");
+
+    rt_uint32_t length = seat_scenario_length_ms();
+    rt_uint32_t wheel_ms = 0, next_ui = 0, next_hour = 0;
+    rt_uint64_t wall = bench_now_ns();
+
+    for (rt_uint32_t now = 0; now <= length; now += step_ms) {
+        rt_tick_t tick = base + rt_tick_from_millisecond(now);
+
+        rt_host_set_tick(tick);
+        seat_scenario_step(now);
+
+        /* 时间轮按虚拟时间推进，与策略线程的节奏一致 */
+        if (now - wheel_ms >= SEAT_CLAIM_WHEEL_TICK_MS) {
+            claim_policy_advance((now - wheel_ms) / SEAT_CLAIM_WHEEL_TICK_MS);
+            wheel_ms += (now - wheel_ms) / SEAT_CLAIM_WHEEL_TICK_MS * SEAT_CLAIM_WHEEL_TICK_MS;
+        }
+
+        if (ui_ms && now >= next_ui) {
+            rt_uint64_t t = bench_now_ns();
+
+            ui_perf_frame_begin();
+            ui_grid_refresh();
+            ui_perf_frame_end();
+            bench_timing_add(&ui_timing, bench_now_ns() - t);
+            next_ui += ui_ms;
+        }
+
+        /* 每分钟检查一次失联座位，每小时输出一行分布 */
+        if (now % 60000 < step_ms) {
+            sample(&occ, tick, rt_tick_from_millisecond(liveness_s * 1000));
+            if (occ.stale > max_stale) {
+                max_stale = occ.stale;
+                max_stale_at = scn->begin + now / 1000;
+            }
+            if (now >= next_hour) {
+                rt_uint32_t tod = scn->begin + now / 1000;
+
+                printf("%02u:%02u %5u %5u %5u %7u %5u\n", tod / 3600, tod / 60 % 60,
+                       occ.count[SEAT_AVAILABLE], occ.count[SEAT_OCCUPIED], occ.count[SEAT_CLAIMED],
+                       occ.expired, occ.stale);
+                next_hour += 3600000;
+            }
+        }
+    }
+    wall = bench_now_ns() - wall;
+
+    if (trace_file) {
+        seat_trace_stop();
+        fclose(trace_file);
+    }
+
+    seat_scenario_get_stats(&scn_stats);
+    seat_ingest_get_stats(&ingest);
+    claim_policy_get_stats(&claim);
+
+    printf("\nSimulated: %u s in %.0f ms wall (%.0fx real time), step %u ms\n",
+           length / 1000, wall / 1e6, wall ? length * 1e6 / wall : 0.0, step_ms);
+    printf("Events   : arrive %u, depart %u, claim %u, flap %u, dropout %u seats\n",
+           scn_stats.kinds[SEAT_SCN_ARRIVE], scn_stats.kinds[SEAT_SCN_DEPART],
+           scn_stats.kinds[SEAT_SCN_CLAIM], scn_stats.kinds[SEAT_SCN_FLAP],
+           scn_stats.kinds[SEAT_SCN_DROPOUT]);
+    printf("Traffic  : %u datagrams, %u reports, %u changes (%u while muted)\n",
+           scn_stats.datagrams, scn_stats.reports, scn_stats.changes, scn_stats.muted);
+    printf("Ingested : %u datagrams, %u records, %u rejected\n",
+           ingest.datagrams, ingest.records, ingest.rejected);
+    printf("Claims   : armed %u, cancelled %u, expired %u (timeout %d s)\n",
+           claim.armed_total, claim.cancelled, claim.expired, SEAT_CLAIM_TIMEOUT_SEC);
+    printf("Liveness : peak %u seats silent > %u s at %02u:%02u\n", max_stale, liveness_s,
+           max_stale_at / 3600, max_stale_at / 60 % 60);
+    bench_timing_print("Ingest", &ingest_timing);
+    if (ui_ms) {
+        printf("UI       : %u grid refreshes every %u ms\n", ui_timing.count, ui_ms);
+        bench_timing_print("Render", &ui_timing);
+    }
+    return 0;
+}
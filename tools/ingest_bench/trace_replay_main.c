@@ -0,0 +1,137 @@
+/*
+ * 追踪回放：读取seat_trace追踪文件（目标板trace dump/stream或ingest_bench -w生成），
+ * 按记录的接收时刻以1倍、N倍或最快速度重新送入seat_ingest解析与数据库，
+ * 输出吞吐与时延，格式与ingest_bench一致。
+ *
+ * 编译：在tools/ingest_bench目录下执行 make trace_replay（见Makefile）
+ *
+ * 用法：
+ *   trace_replay [-x 倍速] 追踪文件
+ *   -x 1为按原始节奏，N为N倍速，0为不等待尽快回放（默认）。
+ *   目标板trace dump的十六进制输出先用 xxd -r -p 还原为二进制文件。
+ *   Latency为处理完成时刻相对计划时刻的滞后，回放跟不上原始节奏时随排队增长。
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <rtthread.h>
+
+#include "seat_db.h"
+#include "claim_policy.h"
+#include "seat_ingest.h"
+#include "seat_trace.h"
+#include "wifi_module.h"
+#include "bench_timing.h"
+
+SeatData g_seat_data;
+
+static void sleep_until_ns(rt_uint64_t deadline)
+{
+    struct timespec ts = { deadline / 1000000000ULL, deadline % 1000000000ULL };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, RT_NULL) != 0) {
+    }
+}
+
+int main(int argc, char **argv)
+{
+    seat_trace_file_t header;
+    seat_trace_rec_t rec;
+    seat_ingest_stats_t stats;
+    bench_timing_t service = { 0 }, latency = { 0 };
+    char buf[SEAT_TRACE_PAYLOAD_MAX + 1];
+    double speed = 0;
+    rt_uint32_t first_tick = 0, last_tick = 0, count = 0;
+    rt_uint64_t start, last_due = 0, elapsed;
+    FILE *fp;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "x:")) != -1) {
+        switch (opt) {
+        case 'x': speed = atof(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-x speed] trace\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-x speed] trace\n", argv[0]);
+        return 2;
+    }
+
+    fp = fopen(argv[optind], "rb");
+    if (fp == RT_NULL) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != SEAT_TRACE_MAGIC ||
+        header.tick_hz == 0) {
+        fprintf(stderr, "%s: not a seat trace\n", argv[optind]);
+        return 1;
+    }
+
+    db_init();
+    claim_policy_init();
+    seat_trace_init();
+    seat_ingest_init();
+
+    start = bench_now_ns();
+    while (fread(&rec, sizeof(rec), 1, fp) == 1) {
+        if (rec.len > SEAT_TRACE_PAYLOAD_MAX || fread(buf, 1, rec.len, fp) != rec.len) {
+            fprintf(stderr, "truncated record %u\n", count);
+            break;
+        }
+        buf[rec.len] = '\0';
+
+        if (count == 0) {
+            first_tick = rec.tick;
+        }
+        last_tick = rec.tick;
+        count++;
+
+        /* 按原始间隔排定计划时刻，滴答回退（流式接收乱序）时不提前 */
+        rt_uint64_t due = start;
+        if (speed > 0) {
+            rt_uint64_t offset = (rt_uint64_t)((rt_int32_t)(rec.tick - first_tick) > 0 ?
+                                               rec.tick - first_tick : 0);
+            due = start + (rt_uint64_t)(offset * 1e9 / header.tick_hz / speed);
+            if (due < last_due) {
+                due = last_due;
+            }
+            last_due = due;
+            sleep_until_ns(due);
+        }
+
+        rt_uint64_t t = bench_now_ns();
+        seat_ingest_datagram(buf, rec.addr, rec.port);
+        rt_uint64_t done = bench_now_ns();
+
+        bench_timing_add(&service, done - t);
+        if (speed > 0) {
+            bench_timing_add(&latency, done - due);
+        }
+    }
+    elapsed = bench_now_ns() - start;
+    fclose(fp);
+
+    rt_uint64_t span_ms = (rt_uint64_t)(last_tick - first_tick) * 1000 / header.tick_hz;
+    double elapsed_ms = elapsed / 1e6;
+
+    printf("Trace    : %u datagrams over %llu ms (%u Hz ticks)\n", count,
+           (unsigned long long)span_ms, header.tick_hz);
+    if (speed > 0) {
+        printf("Replay   : %.2fx, %.0f ms\n", speed, elapsed_ms);
+    } else {
+        printf("Replay   : max speed, %.0f ms\n", elapsed_ms);
+    }
+    printf("Original : %.0f datagram/s\n", span_ms ? count * 1000.0 / span_ms : 0.0);
+    printf("Achieved : %.0f datagram/s\n", elapsed_ms > 0 ? count * 1000.0 / elapsed_ms : 0.0);
+
+    seat_ingest_get_stats(&stats);
+    printf("Ingested : %u datagrams, %u records, %u rejected\n",
+           stats.datagrams, stats.records, stats.rejected);
+    bench_timing_print("Ingest", &service);
+    bench_timing_print("Latency", &latency);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef __DRV_LCD_H__
+#define __DRV_LCD_H__
+
+#include <rtthread.h>
+
+/* 主机端drv_lcd接口，与板载驱动同名同参，绘制到内存中的RGB565帧缓冲 */
+#define LCD_W   240
+#define LCD_H   240
+
+/* 颜色参数顺序与应用代码的用法一致：先文字颜色，后背景颜色 */
+void lcd_set_color(rt_uint16_t fore, rt_uint16_t back);
+void lcd_clear(rt_uint16_t color);
+void lcd_address_set(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2);
+void lcd_draw_point(rt_uint16_t x, rt_uint16_t y);
+void lcd_draw_line(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2);
+void lcd_fill(rt_uint16_t x_start, rt_uint16_t y_start, rt_uint16_t x_end, rt_uint16_t y_end,
+              rt_uint16_t color);
+void lcd_fill_array(rt_uint16_t x_start, rt_uint16_t y_start, rt_uint16_t x_end, rt_uint16_t y_end,
+                    void *pcolor);
+rt_err_t lcd_show_string(rt_uint16_t x, rt_uint16_t y, rt_uint32_t size, const char *fmt, ...);
+
+#endif
@@ -0,0 +1,210 @@
+#include <stdarg.h>
+#include <rtthread.h>
+
+#include "lcd_sim.h"
+
+/* 与板载驱动共用的字库，见lcd_sim_font.c */
+extern const rt_uint8_t asc2_1608[];
+extern const rt_uint8_t asc2_2412[];
+extern const rt_uint8_t asc2_3216[];
+
+rt_uint16_t lcd_sim_fb[LCD_H][LCD_W];
+
+static rt_uint16_t fore_color = 0x0000;
+static rt_uint16_t back_color = 0xFFFF;
+static lcd_sim_stats_t sim_stats;
+
+static void put_pixel(rt_int32_t x, rt_int32_t y, rt_uint16_t color, int api)
+{
+    if (x < 0 || y < 0 || x >= LCD_W || y >= LCD_H) {
+        return;
+    }
+    lcd_sim_fb[y][x] = color;
+    sim_stats.pixels[api]++;
+}
+
+void lcd_set_color(rt_uint16_t fore, rt_uint16_t back)
+{
+    fore_color = fore;
+    back_color = back;
+}
+
+void lcd_clear(rt_uint16_t color)
+{
+    sim_stats.calls[LCD_SIM_CLEAR]++;
+    for (int y = 0; y < LCD_H; y++) {
+        for (int x = 0; x < LCD_W; x++) {
+            put_pixel(x, y, color, LCD_SIM_CLEAR);
+        }
+    }
+}
+
+void lcd_address_set(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2)
+{
+}
+
+void lcd_draw_point(rt_uint16_t x, rt_uint16_t y)
+{
+    sim_stats.calls[LCD_SIM_POINT]++;
+    put_pixel(x, y, fore_color, LCD_SIM_POINT);
+}
+
+void lcd_draw_line(rt_uint16_t x1, rt_uint16_t y1, rt_uint16_t x2, rt_uint16_t y2)
+{
+    rt_int32_t dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    rt_int32_t dy = y2 > y1 ? y1 - y2 : y2 - y1;
+    rt_int32_t sx = x1 < x2 ? 1 : -1;
+    rt_int32_t sy = y1 < y2 ? 1 : -1;
+    rt_int32_t err = dx + dy;
+    rt_int32_t x = x1, y = y1;
+
+    sim_stats.calls[LCD_SIM_LINE]++;
+    while (1) {
+        put_pixel(x, y, fore_color, LCD_SIM_LINE);
+        if (x == x2 && y == y2) {
+            break;
+        }
+        if (2 * err >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (2 * err <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+void lcd_fill(rt_uint16_t x_start, rt_uint16_t y_start, rt_uint16_t x_end, rt_uint16_t y_end,
+              rt_uint16_t color)
+{
+    sim_stats.calls[LCD_SIM_FILL]++;
+    for (int y = y_start; y <= y_end; y++) {
+        for (int x = x_start; x <= x_end; x++) {
+            put_pixel(x, y, color, LCD_SIM_FILL);
+        }
+    }
+}
+
+void lcd_fill_array(rt_uint16_t x_start, rt_uint16_t y_start, rt_uint16_t x_end, rt_uint16_t y_end,
+                    void *pcolor)
+{
+    const rt_uint16_t *pixels = pcolor;
+
+    sim_stats.calls[LCD_SIM_FILL_ARRAY]++;
+    for (int y = y_start; y <= y_end; y++) {
+        for (int x = x_start; x <= x_end; x++) {
+            put_pixel(x, y, *pixels++, LCD_SIM_FILL_ARRAY);
+        }
+    }
+}
+
+static const rt_uint8_t *font_table(rt_uint32_t size)
+{
+    switch (size) {
+    case 16: return asc2_1608;
+    case 24: return asc2_2412;
+    case 32: return asc2_3216;
+    default: return RT_NULL;
+    }
+}
+
+/* 与驱动相同：逐字符绘制前景与背景像素，超出屏幕右边界时停止 */
+rt_err_t lcd_show_string(rt_uint16_t x, rt_uint16_t y, rt_uint32_t size, const char *fmt, ...)
+{
+    const rt_uint8_t *font = font_table(size);
+    rt_uint32_t cw = size / 2;
+    rt_uint32_t stride = (cw + 7) / 8;
+    char buf[64];
+    va_list args;
+
+    if (font == RT_NULL) {
+        return -RT_EINVAL;
+    }
+
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    sim_stats.calls[LCD_SIM_STRING]++;
+    for (const char *p = buf; *p && x + cw <= LCD_W; p++, x += cw) {
+        rt_uint8_t ch = (*p < ' ' || *p > '~') ? ' ' : *p;
+        const rt_uint8_t *glyph = font + (ch - ' ') * stride * size;
+
+        for (rt_uint32_t row = 0; row < size; row++) {
+            for (rt_uint32_t col = 0; col < cw; col++) {
+                rt_bool_t on = glyph[row * stride + col / 8] & (0x80 >> (col % 8));
+                put_pixel(x + col, y + row, on ? fore_color : back_color, LCD_SIM_STRING);
+            }
+        }
+    }
+    return RT_EOK;
+}
+
+void lcd_sim_reset_stats(void)
+{
+    rt_memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+void lcd_sim_get_stats(lcd_sim_stats_t *stats)
+{
+    *stats = sim_stats;
+}
+
+rt_uint32_t lcd_sim_total_pixels(const lcd_sim_stats_t *stats)
+{
+    rt_uint32_t total = 0;
+
+    for (int i = 0; i < LCD_SIM_API_NUM; i++) {
+        total += stats->pixels[i];
+    }
+    return total;
+}
+
+void lcd_sim_print_stats(FILE *fp, const lcd_sim_stats_t *stats)
+{
+    static const char *names[LCD_SIM_API_NUM] = {
+        "clear", "fill", "fill_array", "line", "point", "string",
+    };
+
+    for (int i = 0; i < LCD_SIM_API_NUM; i++) {
+        if (stats->calls[i]) {
+            fprintf(fp, "    %-10s calls %5u  pixels %7u\n", names[i], stats->calls[i], stats->pixels[i]);
+        }
+    }
+}
+
+rt_uint32_t lcd_sim_checksum(void)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)lcd_sim_fb;
+    rt_uint32_t hash = 2166136261u;
+
+    for (rt_size_t i = 0; i < sizeof(lcd_sim_fb); i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int lcd_sim_dump_ppm(const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+
+    if (fp == RT_NULL) {
+        return -1;
+    }
+
+    fprintf(fp, "P6\n%d %d\n255\n", LCD_W, LCD_H);
+    for (int y = 0; y < LCD_H; y++) {
+        for (int x = 0; x < LCD_W; x++) {
+            rt_uint16_t c = lcd_sim_fb[y][x];
+            rt_uint8_t rgb[3] = {
+                (rt_uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+                (rt_uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                (rt_uint8_t)((c & 0x1F) * 255 / 31),
+            };
+            fwrite(rgb, 1, sizeof(rgb), fp);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
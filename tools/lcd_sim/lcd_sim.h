@@ -0,0 +1,36 @@
+#ifndef __LCD_SIM_H__
+#define __LCD_SIM_H__
+
+#include <stdio.h>
+#include <rtthread.h>
+#include "drv_lcd.h"
+
+/* 按接口统计调用次数与写入像素数 */
+enum {
+    LCD_SIM_CLEAR = 0,
+    LCD_SIM_FILL,
+    LCD_SIM_FILL_ARRAY,
+    LCD_SIM_LINE,
+    LCD_SIM_POINT,
+    LCD_SIM_STRING,
+    LCD_SIM_API_NUM,
+};
+
+typedef struct {
+    rt_uint32_t calls[LCD_SIM_API_NUM];
+    rt_uint32_t pixels[LCD_SIM_API_NUM];
+} lcd_sim_stats_t;
+
+extern rt_uint16_t lcd_sim_fb[LCD_H][LCD_W];
+
+void lcd_sim_reset_stats(void);
+void lcd_sim_get_stats(lcd_sim_stats_t *stats);
+rt_uint32_t lcd_sim_total_pixels(const lcd_sim_stats_t *stats);
+void lcd_sim_print_stats(FILE *fp, const lcd_sim_stats_t *stats);
+
+/* 帧缓冲FNV-1a校验和，用于与基准图比对 */
+rt_uint32_t lcd_sim_checksum(void);
+/* 以PPM(P6)格式保存当前帧缓冲 */
+int lcd_sim_dump_ppm(const char *path);
+
+#endif
@@ -0,0 +1,37 @@
+#include <rtthread.h>
+
+/*
+ * 字库：与板载驱动相同的asc2_1608/asc2_2412/asc2_3216布局
+ * （可见ASCII，每字符size行，每行(size/2+7)/8字节，高位在左）。
+ * 编译时以-DLCD_SIM_BSP_FONT='"<BSP路径>/board/ports/lcd/lcd_font.h"'引入驱动字库，
+ * 得到与实机一致的图像；未指定时使用方框占位字形，布局与像素计数不变。
+ */
+#ifdef LCD_SIM_BSP_FONT
+#include LCD_SIM_BSP_FONT
+#else
+
+#define REP2(...)   __VA_ARGS__ __VA_ARGS__
+#define REP4(...)   REP2(__VA_ARGS__) REP2(__VA_ARGS__)
+#define REP8(...)   REP4(__VA_ARGS__) REP4(__VA_ARGS__)
+#define REP16(...)  REP8(__VA_ARGS__) REP8(__VA_ARGS__)
+#define REP32(...)  REP16(__VA_ARGS__) REP16(__VA_ARGS__)
+#define REP64(...)  REP32(__VA_ARGS__) REP32(__VA_ARGS__)
+/* 空格之后的94个可见字符 */
+#define REP94(...)  REP64(__VA_ARGS__) REP16(__VA_ARGS__) REP8(__VA_ARGS__) \
+                    REP4(__VA_ARGS__) REP2(__VA_ARGS__)
+
+#define BLANK16     REP16(0x00,)
+#define BOX16       0x00, 0x7E, REP8(0x42,) REP4(0x42,) 0x7E, 0x00,
+
+#define BLANK24     REP32(0x00,) REP16(0x00,)
+#define BOX24       0x00, 0x00, 0x7F, 0xE0, REP16(0x40, 0x20,) REP4(0x40, 0x20,) 0x7F, 0xE0, 0x00, 0x00,
+
+#define BLANK32     REP64(0x00,)
+#define BOX32       0x00, 0x00, 0x7F, 0xFE, REP16(0x40, 0x02,) REP8(0x40, 0x02,) REP4(0x40, 0x02,) \
+                    0x7F, 0xFE, 0x00, 0x00,
+
+const rt_uint8_t asc2_1608[95 * 16] = { BLANK16 REP94(BOX16) };
+const rt_uint8_t asc2_2412[95 * 48] = { BLANK24 REP94(BOX24) };
+const rt_uint8_t asc2_3216[95 * 64] = { BLANK32 REP94(BOX32) };
+
+#endif
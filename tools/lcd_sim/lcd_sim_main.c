@@ -0,0 +1,265 @@
+/*
+ * LCD主机模拟器：在Linux上运行显示代码，输出每个场景的像素计数、耗时与帧缓冲校验和，
+ * 并可保存PPM截图、与基准校验和比对。
+ *
+ * 编译：在tools/lcd_sim目录下执行 make lcd_sim（见Makefile）
+ *
+ * 用法：
+ *   lcd_sim [-o 截图目录] [-w 基准文件] [-c 基准文件]
+ *   -w 写入各场景校验和，-c 与之比对，不一致时返回非零（用于CI）。
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <rtthread.h>
+
+#include "lcd_sim.h"
+#include "seat_db.h"
+#include "ui_single.h"
+#include "ui_grid.h"
+#include "ui_pager.h"
+#include "ui_perf.h"
+#include "lcd_tile.h"
+#include "label_cache.h"
+#include "lcd_colors.h"
+#include "wifi_module.h"
+
+SeatData g_seat_data;
+
+#define MAX_SCENES  16
+
+typedef struct {
+    const char *name;
+    rt_uint32_t checksum;
+} scene_result_t;
+
+static scene_result_t results[MAX_SCENES];
+static int result_count;
+static const char *snap_dir;
+static char scene_note[96];                 // 场景附加说明，随统计一并输出
+
+static void select_seat(const char *seat_id, const char *status)
+{
+    rt_strncpy(g_seat_data.seat_id, seat_id, sizeof(g_seat_data.seat_id) - 1);
+    rt_strncpy(g_seat_data.status, status, sizeof(g_seat_data.status) - 1);
+    g_seat_data.new_data = RT_TRUE;
+}
+
+/* 运行一个场景：统计像素、计时、计算校验和并按需保存截图 */
+static void run_scene(const char *name, void (*render)(void))
+{
+    struct timespec t0, t1;
+    lcd_sim_stats_t stats;
+    double us;
+
+    lcd_sim_reset_stats();
+    scene_note[0] = '\0';
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    ui_perf_frame_begin();
+    render();
+    ui_perf_frame_end();
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    lcd_sim_get_stats(&stats);
+
+    us = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_nsec - t0.tv_nsec) / 1e3;
+    results[result_count].name = name;
+    results[result_count].checksum = lcd_sim_checksum();
+
+    printf("%-18s pixels %7u  time %8.1f us  checksum %08x\n", name,
+           lcd_sim_total_pixels(&stats), us, results[result_count].checksum);
+    lcd_sim_print_stats(stdout, &stats);
+    if (scene_note[0]) {
+        printf("    %s\n", scene_note);
+    }
+
+    if (snap_dir) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s.ppm", snap_dir, name);
+        if (lcd_sim_dump_ppm(path) != 0) {
+            fprintf(stderr, "cannot write %s\n", path);
+        }
+    }
+    result_count++;
+}
+
+static void scene_single_first(void)
+{
+    lcd_clear(WHITE);
+    ui_single_invalidate();
+    select_seat("A01", "0");
+    show_seat_on_lcd();
+}
+
+static void scene_single_status(void)
+{
+    db_update_seat_status(1, SEAT_OCCUPIED);
+    select_seat("A01", "1");
+    show_seat_on_lcd();
+}
+
+static void scene_single_repeat(void)
+{
+    db_update_seat_status(1, SEAT_OCCUPIED);
+    select_seat("A01", "1");
+    show_seat_on_lcd();
+}
+
+static void scene_single_switch(void)
+{
+    db_update_seat_status(2, SEAT_CLAIMED);
+    select_seat("A02", "2");
+    show_seat_on_lcd();
+}
+
+static void scene_grid_full(void)
+{
+    ui_grid_set_origin(1);
+    ui_grid_refresh();
+}
+
+static void scene_grid_update(void)
+{
+    db_update_seat_status(3, SEAT_OCCUPIED);
+    db_update_seat_status(17, SEAT_CLAIMED);
+    db_update_seat_status(40, SEAT_AVAILABLE);
+    ui_grid_refresh();
+}
+
+static void scene_grid_idle(void)
+{
+    ui_grid_refresh();
+}
+
+/* 分页视图按渲染片驱动，打印片数与单片最大像素数 */
+static void pager_run(void)
+{
+    ui_pager_stats_t before, after;
+
+    ui_pager_get_stats(&before);
+    while (ui_pager_refresh()) {
+    }
+    ui_pager_get_stats(&after);
+    snprintf(scene_note, sizeof(scene_note), "slices %u, max slice %u px",
+             after.slices - before.slices, after.slice_pixels_max);
+}
+
+static void scene_page_first(void)
+{
+    lcd_clear(WHITE);
+    ui_pager_invalidate();
+    pager_run();
+}
+
+static void scene_page_flip(void)
+{
+    ui_pager_next();
+    pager_run();
+}
+
+static void scene_page_update(void)
+{
+    db_update_seat_status(33, SEAT_CLAIMED);
+    pager_run();
+}
+
+static void scene_page_idle(void)
+{
+    pager_run();
+}
+
+/* 末页：SEAT_ID_LIMIT不是分区大小的整数倍时只有部分格子 */
+static void scene_page_last(void)
+{
+    ui_pager_goto(SEAT_ZONE_COUNT - 1);
+    pager_run();
+}
+
+static int write_golden(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+
+    if (fp == RT_NULL) {
+        return -1;
+    }
+    for (int i = 0; i < result_count; i++) {
+        fprintf(fp, "%s %08x\n", results[i].name, results[i].checksum);
+    }
+    fclose(fp);
+    return 0;
+}
+
+static int check_golden(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    char name[64];
+    unsigned int checksum;
+    int failed = 0;
+
+    if (fp == RT_NULL) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return -1;
+    }
+    while (fscanf(fp, "%63s %x", name, &checksum) == 2) {
+        for (int i = 0; i < result_count; i++) {
+            if (strcmp(results[i].name, name) == 0 && results[i].checksum != checksum) {
+                printf("MISMATCH %s: expected %08x, got %08x\n", name, checksum, results[i].checksum);
+                failed++;
+            }
+        }
+    }
+    fclose(fp);
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    const char *golden_out = RT_NULL, *golden_in = RT_NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:w:c:")) != -1) {
+        switch (opt) {
+        case 'o': snap_dir = optarg; break;
+        case 'w': golden_out = optarg; break;
+        case 'c': golden_in = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-o dir] [-w golden] [-c golden]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    db_init();
+    lcd_tile_init(&lcd_tile_sync_backend);
+    label_cache_init();
+    ui_pager_init();
+    ui_perf_init();
+    for (rt_uint16_t id = 1; id <= 48; id++) {
+        db_update_seat_status(id, (SeatStatus)(id % SEAT_STATUS_NUM));
+    }
+    db_update_seat_status(1, SEAT_AVAILABLE);
+
+    run_scene("single_first", scene_single_first);
+    run_scene("single_status", scene_single_status);
+    run_scene("single_repeat", scene_single_repeat);
+    run_scene("single_switch", scene_single_switch);
+    run_scene("grid_full", scene_grid_full);
+    run_scene("grid_update", scene_grid_update);
+    run_scene("grid_idle", scene_grid_idle);
+    run_scene("page_first", scene_page_first);
+    run_scene("page_flip", scene_page_flip);
+    run_scene("page_update", scene_page_update);
+    run_scene("page_idle", scene_page_idle);
+    run_scene("page_last", scene_page_last);
+
+    printf("\n");
+    ui_perf_dump();
+
+    if (golden_out && write_golden(golden_out) != 0) {
+        fprintf(stderr, "cannot write %s\n", golden_out);
+        return 1;
+    }
+    if (golden_in) {
+        return check_golden(golden_in) ? 1 : 0;
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef __FINSH_H__
+#define __FINSH_H__
+
+#include <rtthread.h>
+
+/* 主机端不注册msh命令，保留一个函数指针引用，函数仍可直接调用且不会报未使用 */
+#define MSH_CMD_EXPORT(command, desc) \
+    static void *const __msh_##command __attribute__((used)) = (void *)command
+#define MSH_CMD_EXPORT_ALIAS(command, alias, desc) \
+    static void *const __msh_##alias __attribute__((used)) = (void *)command
+
+#endif
@@ -0,0 +1,357 @@
+#include <rtthread.h>
+#include <rthw.h>
+#include <rtdevice.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 主机端RT-Thread替身实现，单线程运行 */
+
+static rt_bool_t tick_virtual = RT_FALSE;
+static rt_tick_t tick_now;
+
+void rt_host_set_tick(rt_tick_t tick)
+{
+    tick_virtual = RT_TRUE;
+    tick_now = tick;
+}
+
+rt_tick_t rt_tick_get(void)
+{
+    struct timespec ts;
+
+    if (tick_virtual) {
+        return tick_now;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_tick_t)(ts.tv_sec * RT_TICK_PER_SECOND + ts.tv_nsec / (1000000000 / RT_TICK_PER_SECOND));
+}
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    return ms < 0 ? (rt_tick_t)RT_WAITING_FOREVER : (rt_tick_t)(ms * RT_TICK_PER_SECOND / 1000);
+}
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+
+    nanosleep(&ts, RT_NULL);
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    return rt_thread_mdelay(tick * 1000 / RT_TICK_PER_SECOND);
+}
+
+rt_err_t rt_thread_init(struct rt_thread *thread, const char *name, void (*entry)(void *),
+                        void *parameter, void *stack_start, rt_uint32_t stack_size,
+                        rt_uint8_t priority, rt_uint32_t tick)
+{
+    thread->name = name;
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_startup(rt_thread_t thread)
+{
+    return RT_EOK;
+}
+
+/* 定时器链表，rt_host_timer_run按虚拟时钟逐个触发到期的定时器 */
+static struct rt_timer *timer_list;
+
+void rt_timer_init(rt_timer_t timer, const char *name, void (*timeout)(void *parameter),
+                   void *parameter, rt_tick_t time, rt_uint8_t flag)
+{
+    timer->name = name;
+    timer->timeout_func = timeout;
+    timer->parameter = parameter;
+    timer->init_tick = time;
+    timer->timeout_tick = 0;
+    timer->flag = flag & ~RT_TIMER_FLAG_ACTIVATED;
+    timer->next = timer_list;
+    timer_list = timer;
+}
+
+rt_err_t rt_timer_detach(rt_timer_t timer)
+{
+    for (struct rt_timer **p = &timer_list; *p; p = &(*p)->next) {
+        if (*p == timer) {
+            *p = timer->next;
+            break;
+        }
+    }
+    timer->flag &= ~RT_TIMER_FLAG_ACTIVATED;
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_start(rt_timer_t timer)
+{
+    timer->timeout_tick = rt_tick_get() + timer->init_tick;
+    timer->flag |= RT_TIMER_FLAG_ACTIVATED;
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_stop(rt_timer_t timer)
+{
+    if (!(timer->flag & RT_TIMER_FLAG_ACTIVATED)) {
+        return -RT_ERROR;
+    }
+    timer->flag &= ~RT_TIMER_FLAG_ACTIVATED;
+    return RT_EOK;
+}
+
+rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg)
+{
+    switch (cmd) {
+    case RT_TIMER_CTRL_SET_TIME:
+        timer->init_tick = *(rt_tick_t *)arg;
+        break;
+    case RT_TIMER_CTRL_GET_TIME:
+        *(rt_tick_t *)arg = timer->init_tick;
+        break;
+    case RT_TIMER_CTRL_SET_ONESHOT:
+        timer->flag &= ~RT_TIMER_FLAG_PERIODIC;
+        break;
+    case RT_TIMER_CTRL_SET_PERIODIC:
+        timer->flag |= RT_TIMER_FLAG_PERIODIC;
+        break;
+    default:
+        return -RT_EINVAL;
+    }
+    return RT_EOK;
+}
+
+void rt_host_timer_run(rt_tick_t tick)
+{
+    for (;;) {
+        struct rt_timer *due = RT_NULL;
+
+        /* 取最早到期的定时器，回调可能重新启动或停止任意定时器，每次都重新查找 */
+        for (struct rt_timer *t = timer_list; t; t = t->next) {
+            if ((t->flag & RT_TIMER_FLAG_ACTIVATED) && (rt_int32_t)(t->timeout_tick - tick) <= 0 &&
+                (due == RT_NULL || (rt_int32_t)(t->timeout_tick - due->timeout_tick) < 0)) {
+                due = t;
+            }
+        }
+        if (due == RT_NULL) {
+            break;
+        }
+
+        rt_host_set_tick(due->timeout_tick);
+        if (due->flag & RT_TIMER_FLAG_PERIODIC) {
+            due->timeout_tick += due->init_tick;
+        } else {
+            due->flag &= ~RT_TIMER_FLAG_ACTIVATED;
+        }
+        due->timeout_func(due->parameter);
+    }
+    rt_host_set_tick(tick);
+}
+
+/* 设备链表，按名称查找 */
+static struct rt_device *device_list;
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if (rt_device_find(name) != RT_NULL) {
+        return -RT_ERROR;
+    }
+    dev->name = name;
+    dev->flag = flags;
+    dev->next = device_list;
+    device_list = dev;
+    return RT_EOK;
+}
+
+rt_device_t rt_device_find(const char *name)
+{
+    for (struct rt_device *dev = device_list; dev; dev = dev->next) {
+        if (strcmp(dev->name, name) == 0) {
+            return dev;
+        }
+    }
+    return RT_NULL;
+}
+
+rt_err_t rt_device_init(rt_device_t dev)
+{
+    rt_err_t result = RT_EOK;
+
+    if (dev->init && !(dev->flag & RT_DEVICE_FLAG_ACTIVATED)) {
+        result = dev->init(dev);
+        if (result == RT_EOK) {
+            dev->flag |= RT_DEVICE_FLAG_ACTIVATED;
+        }
+    }
+    return result;
+}
+
+rt_err_t rt_device_control(rt_device_t dev, int cmd, void *arg)
+{
+    return dev->control ? dev->control(dev, cmd, arg) : -RT_ENOSYS;
+}
+
+/* 看门狗框架：设备操作转交驱动ops */
+static rt_err_t watchdog_init(rt_device_t dev)
+{
+    rt_watchdog_t *wdt = (rt_watchdog_t *)dev;
+
+    return wdt->ops->init ? wdt->ops->init(wdt) : RT_EOK;
+}
+
+static rt_err_t watchdog_control(rt_device_t dev, int cmd, void *args)
+{
+    rt_watchdog_t *wdt = (rt_watchdog_t *)dev;
+
+    return wdt->ops->control(wdt, cmd, args);
+}
+
+rt_err_t rt_hw_watchdog_register(rt_watchdog_t *wdt, const char *name, rt_uint32_t flag, void *data)
+{
+    wdt->parent.init = watchdog_init;
+    wdt->parent.control = watchdog_control;
+    wdt->parent.user_data = data;
+    return rt_device_register(&wdt->parent, name, flag);
+}
+
+void rt_hw_cpu_reset(void)
+{
+    fprintf(stderr, "rt_hw_cpu_reset\n");
+    exit(3);
+}
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    mutex->hold = 0;
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    mutex->hold++;
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    mutex->hold--;
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_init(rt_sem_t sem, const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+    sem->value = value;
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
+{
+    if (sem->value == 0) {
+        return -RT_ETIMEOUT;
+    }
+    sem->value--;
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_trytake(rt_sem_t sem)
+{
+    return rt_sem_take(sem, RT_WAITING_NO);
+}
+
+rt_err_t rt_sem_release(rt_sem_t sem)
+{
+    sem->value++;
+    return RT_EOK;
+}
+
+rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag)
+{
+    event->set = 0;
+    return RT_EOK;
+}
+
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
+{
+    event->set |= set;
+    return RT_EOK;
+}
+
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+                       rt_int32_t timeout, rt_uint32_t *recved)
+{
+    rt_uint32_t hit = event->set & set;
+
+    if ((opt & RT_EVENT_FLAG_AND) ? hit != set : hit == 0) {
+        return -RT_ETIMEOUT;
+    }
+    if (recved) {
+        *recved = hit;
+    }
+    if (opt & RT_EVENT_FLAG_CLEAR) {
+        event->set &= ~hit;
+    }
+    return RT_EOK;
+}
+
+/* 块池：块前保存所属池指针，与内核布局一致 */
+rt_err_t rt_mp_init(struct rt_mempool *mp, const char *name, void *start, rt_size_t size,
+                    rt_size_t block_size)
+{
+    rt_size_t stride;
+    rt_uint8_t *p = start;
+
+    block_size = RT_ALIGN(block_size, RT_ALIGN_SIZE);
+    stride = block_size + sizeof(rt_uint8_t *);
+
+    mp->block_size = block_size;
+    mp->block_total_count = size / stride;
+    mp->block_free_count = mp->block_total_count;
+    mp->block_list = RT_NULL;
+
+    for (rt_size_t i = mp->block_total_count; i > 0; i--) {
+        rt_uint8_t *block = p + (i - 1) * stride;
+        *(void **)block = mp->block_list;
+        mp->block_list = block;
+    }
+    return RT_EOK;
+}
+
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
+{
+    rt_uint8_t *block = mp->block_list;
+
+    if (block == RT_NULL) {
+        return RT_NULL;
+    }
+    mp->block_list = *(void **)block;
+    mp->block_free_count--;
+    *(rt_mp_t *)block = mp;
+    return block + sizeof(rt_uint8_t *);
+}
+
+void rt_mp_free(void *ptr)
+{
+    rt_uint8_t *block = (rt_uint8_t *)ptr - sizeof(rt_uint8_t *);
+    rt_mp_t mp = *(rt_mp_t *)block;
+
+    *(void **)block = mp->block_list;
+    mp->block_list = block;
+    mp->block_free_count++;
+}
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+void rt_memory_info(rt_size_t *total, rt_size_t *used, rt_size_t *max_used)
+{
+    *total = *used = *max_used = 0;
+}
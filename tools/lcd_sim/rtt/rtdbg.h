@@ -0,0 +1,13 @@
+#ifndef __RT_DBG_H__
+#define __RT_DBG_H__
+
+#include <stdio.h>
+
+/* 主机端日志：带标签输出到stderr，不影响标准输出上的测量结果 */
+#define DBG_LOG                 3
+#define LOG_E(fmt, ...)         fprintf(stderr, "E/" DBG_TAG ": " fmt "\n", ##__VA_ARGS__)
+#define LOG_W(fmt, ...)         fprintf(stderr, "W/" DBG_TAG ": " fmt "\n", ##__VA_ARGS__)
+#define LOG_I(fmt, ...)         fprintf(stderr, "I/" DBG_TAG ": " fmt "\n", ##__VA_ARGS__)
+#define LOG_D(fmt, ...)         fprintf(stderr, "D/" DBG_TAG ": " fmt "\n", ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef __RT_DEVICE_H__
+#define __RT_DEVICE_H__
+
+#include <rtthread.h>
+
+/* 主机端无GPIO，引脚接口为空操作 */
+#define GET_PIN(port, pin)      ((rt_base_t)((#port[0] - 'A') * 16 + (pin)))
+#define PIN_MODE_OUTPUT         0x00
+#define PIN_MODE_INPUT_PULLUP   0x02
+#define PIN_IRQ_MODE_FALLING    0x01
+#define PIN_IRQ_ENABLE          0x01
+
+rt_inline void rt_pin_mode(rt_base_t pin, rt_uint8_t mode) { }
+rt_inline rt_err_t rt_pin_attach_irq(rt_base_t pin, rt_uint8_t mode, void (*hdr)(void *args), void *args)
+{
+    return RT_EOK;
+}
+rt_inline rt_err_t rt_pin_irq_enable(rt_base_t pin, rt_uint8_t enabled) { return RT_EOK; }
+
+/* 看门狗设备框架，与components/drivers/watchdog一致 */
+#define RT_DEVICE_CTRL_WDT_GET_TIMEOUT    (1)
+#define RT_DEVICE_CTRL_WDT_SET_TIMEOUT    (2)
+#define RT_DEVICE_CTRL_WDT_GET_TIMELEFT   (3)
+#define RT_DEVICE_CTRL_WDT_KEEPALIVE      (4)
+#define RT_DEVICE_CTRL_WDT_START          (5)
+#define RT_DEVICE_CTRL_WDT_STOP           (6)
+
+struct rt_watchdog_ops;
+struct rt_watchdog_device {
+    struct rt_device parent;
+    const struct rt_watchdog_ops *ops;
+};
+typedef struct rt_watchdog_device rt_watchdog_t;
+
+struct rt_watchdog_ops {
+    rt_err_t (*init)(rt_watchdog_t *wdt);
+    rt_err_t (*control)(rt_watchdog_t *wdt, int cmd, void *arg);
+};
+
+rt_err_t rt_hw_watchdog_register(rt_watchdog_t *wdt, const char *name, rt_uint32_t flag, void *data);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef __RT_HW_H__
+#define __RT_HW_H__
+
+#include <rtthread.h>
+
+/* 主机端单线程运行，关中断为空操作 */
+rt_inline rt_base_t rt_hw_interrupt_disable(void) { return 0; }
+rt_inline void rt_hw_interrupt_enable(rt_base_t level) { (void)level; }
+rt_inline void rt_interrupt_enter(void) { }
+rt_inline void rt_interrupt_leave(void) { }
+
+/* 主机端复位即退出进程 */
+void rt_hw_cpu_reset(void);
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef __RT_THREAD_H__
+#define __RT_THREAD_H__
+
+/* 主机端RT-Thread最小替身：仅覆盖显示相关模块用到的类型与接口，单线程运行 */
+#include <rtconfig.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 主机端没有BSP外设驱动，需要的设备由applications中的桩注册 */
+#undef BSP_USING_WDT
+
+typedef int8_t      rt_int8_t;
+typedef int16_t     rt_int16_t;
+typedef int32_t     rt_int32_t;
+typedef uint8_t     rt_uint8_t;
+typedef uint16_t    rt_uint16_t;
+typedef uint32_t    rt_uint32_t;
+typedef uint64_t    rt_uint64_t;
+typedef int         rt_bool_t;
+typedef int32_t     rt_base_t;
+typedef uint32_t    rt_ubase_t;
+typedef rt_base_t   rt_err_t;
+typedef rt_uint32_t rt_tick_t;
+typedef rt_ubase_t  rt_size_t;
+
+#define RT_TRUE                 1
+#define RT_FALSE                0
+#define RT_NULL                 ((void *)0)
+
+#define RT_EOK                  0
+#define RT_ERROR                1
+#define RT_ETIMEOUT             2
+#define RT_EFULL                3
+#define RT_EEMPTY               4
+#define RT_ENOMEM               5
+#define RT_ENOSYS               6
+#define RT_EBUSY                7
+#define RT_EINVAL               10
+
+#define RT_WAITING_FOREVER      -1
+#define RT_WAITING_NO           0
+#define RT_IPC_FLAG_FIFO        0x00
+#define RT_IPC_FLAG_PRIO        0x01
+#define RT_EVENT_FLAG_AND       0x01
+#define RT_EVENT_FLAG_OR        0x02
+#define RT_EVENT_FLAG_CLEAR     0x04
+
+#define RT_TIMER_FLAG_DEACTIVATED   0x0
+#define RT_TIMER_FLAG_ACTIVATED     0x1
+#define RT_TIMER_FLAG_ONE_SHOT      0x0
+#define RT_TIMER_FLAG_PERIODIC      0x2
+#define RT_TIMER_FLAG_HARD_TIMER    0x0
+#define RT_TIMER_FLAG_SOFT_TIMER    0x4
+#define RT_TIMER_CTRL_SET_TIME      0x0
+#define RT_TIMER_CTRL_GET_TIME      0x1
+#define RT_TIMER_CTRL_SET_ONESHOT   0x2
+#define RT_TIMER_CTRL_SET_PERIODIC  0x3
+
+#define RT_DEVICE_FLAG_DEACTIVATE   0x000
+#define RT_DEVICE_FLAG_ACTIVATED    0x010
+
+#define RT_ALIGN_SIZE           4
+#define RT_ALIGN(size, align)   (((size) + (align) - 1) & ~((align) - 1))
+#define ALIGN(n)                __attribute__((aligned(n)))
+#define rt_inline               static __inline
+#define RT_ARRAY_SIZE(arr)      (sizeof(arr) / sizeof(arr[0]))
+#define RT_ASSERT(x)
+
+/* 自动初始化：主机端以构造函数在main之前调用 */
+#define RT_HOST_INIT_EXPORT(fn) \
+    static void __rt_init_##fn(void) __attribute__((constructor)); \
+    static void __rt_init_##fn(void) { fn(); }
+#define INIT_DEVICE_EXPORT(fn)  RT_HOST_INIT_EXPORT(fn)
+#define INIT_APP_EXPORT(fn)     RT_HOST_INIT_EXPORT(fn)
+
+#ifndef RT_TICK_PER_SECOND
+#define RT_TICK_PER_SECOND      1000
+#endif
+#ifndef RT_THREAD_PRIORITY_MAX
+#define RT_THREAD_PRIORITY_MAX  32
+#endif
+
+struct rt_mutex     { rt_uint32_t hold; };
+struct rt_semaphore { rt_uint32_t value; };
+struct rt_event     { rt_uint32_t set; };
+struct rt_thread    { const char *name; };
+struct rt_mempool {
+    void *block_list;
+    rt_size_t block_size;
+    rt_size_t block_total_count;
+    rt_size_t block_free_count;
+};
+
+typedef struct rt_mutex *rt_mutex_t;
+typedef struct rt_semaphore *rt_sem_t;
+typedef struct rt_event *rt_event_t;
+typedef struct rt_thread *rt_thread_t;
+typedef struct rt_mempool *rt_mp_t;
+
+struct rt_timer {
+    const char *name;
+    void (*timeout_func)(void *parameter);
+    void *parameter;
+    rt_tick_t init_tick;
+    rt_tick_t timeout_tick;
+    rt_uint8_t flag;
+    struct rt_timer *next;      // 已初始化的定时器链表
+};
+typedef struct rt_timer *rt_timer_t;
+
+/* 设备：只保留看门狗等桩设备用到的init与control */
+typedef struct rt_device *rt_device_t;
+struct rt_device {
+    const char *name;
+    rt_uint16_t flag;
+    rt_err_t (*init)(rt_device_t dev);
+    rt_err_t (*control)(rt_device_t dev, int cmd, void *args);
+    void *user_data;
+    struct rt_device *next;     // 已注册的设备链表
+};
+
+/* 时钟：以CLOCK_MONOTONIC折算的毫秒数作为滴答 */
+rt_tick_t rt_tick_get(void);
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms);
+rt_err_t rt_thread_mdelay(rt_int32_t ms);
+rt_err_t rt_thread_delay(rt_tick_t tick);
+/* 主机专用：切换到由模拟器推进的虚拟时钟，此后rt_tick_get返回最近一次设置的值 */
+void rt_host_set_tick(rt_tick_t tick);
+
+/* 线程：主机端不创建线程，init/startup仅返回成功 */
+rt_err_t rt_thread_init(struct rt_thread *thread, const char *name, void (*entry)(void *),
+                        void *parameter, void *stack_start, rt_uint32_t stack_size,
+                        rt_uint8_t priority, rt_uint32_t tick);
+rt_err_t rt_thread_startup(rt_thread_t thread);
+
+/* 定时器：主机端不自行计时，到期回调由rt_host_timer_run在虚拟时钟上触发 */
+void rt_timer_init(rt_timer_t timer, const char *name, void (*timeout)(void *parameter),
+                   void *parameter, rt_tick_t time, rt_uint8_t flag);
+rt_err_t rt_timer_detach(rt_timer_t timer);
+rt_err_t rt_timer_start(rt_timer_t timer);
+rt_err_t rt_timer_stop(rt_timer_t timer);
+rt_err_t rt_timer_control(rt_timer_t timer, int cmd, void *arg);
+/* 主机专用：把虚拟时钟推进到tick，其间到期的定时器按到期先后在各自的到期时刻回调 */
+void rt_host_timer_run(rt_tick_t tick);
+
+/* 设备 */
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags);
+rt_device_t rt_device_find(const char *name);
+rt_err_t rt_device_init(rt_device_t dev);
+rt_err_t rt_device_control(rt_device_t dev, int cmd, void *arg);
+
+/* IPC：单线程下不会阻塞，信号量不足时返回超时 */
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag);
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time);
+rt_err_t rt_mutex_release(rt_mutex_t mutex);
+rt_err_t rt_sem_init(rt_sem_t sem, const char *name, rt_uint32_t value, rt_uint8_t flag);
+rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time);
+rt_err_t rt_sem_trytake(rt_sem_t sem);
+rt_err_t rt_sem_release(rt_sem_t sem);
+rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag);
+rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set);
+rt_err_t rt_event_recv(rt_event_t event, rt_uint32_t set, rt_uint8_t opt,
+                       rt_int32_t timeout, rt_uint32_t *recved);
+
+/* 内存 */
+rt_err_t rt_mp_init(struct rt_mempool *mp, const char *name, void *start, rt_size_t size,
+                    rt_size_t block_size);
+void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time);
+void rt_mp_free(void *block);
+void *rt_malloc(rt_size_t size);
+void rt_free(void *ptr);
+void rt_memory_info(rt_size_t *total, rt_size_t *used, rt_size_t *max_used);
+
+#define rt_memset               memset
+#define rt_memcpy               memcpy
+#define rt_strlen               strlen
+#define rt_strncpy              strncpy
+#define rt_snprintf             snprintf
+#define rt_sprintf              sprintf
+#define rt_kprintf              printf
+#define __rt_ffs(v)             __builtin_ffs(v)
+
+#endif
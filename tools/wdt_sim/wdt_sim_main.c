@@ -0,0 +1,129 @@
+/*
+ * 软件看门狗仿真：soft_wdt与wdt_stub在主机替身上运行，监督定时器由虚拟时钟驱动，
+ * 按目标板的截止时间注册ui与udp_recv两个心跳通道，统计监督定时器的唤醒次数，
+ * 可让udp_recv在指定时刻停止心跳，测量超时从最后一次心跳到被报告的间隔。
+ *
+ * 编译：在tools/wdt_sim目录下执行make
+ *
+ * 用法：
+ *   wdt_sim [-t 秒] [-u ui心跳间隔ms] [-p udp心跳间隔ms] [-s udp停止心跳的秒] [-d 停止时长ms] [-n]
+ *   默认运行60秒，两个线程空闲时都每1000ms心跳一次（UI_MAX_REFRESH_MS与UDP_RECV_TIMEOUT_MS）。
+ *   -s 0为不停止；-d 0为停止到结束。-n 不接入硬件看门狗（默认接入wdt_stub注册的"wdt"）。
+ *   硬件看门狗喂晚时wdt_stub在stderr上告警。
+ */
+#include <stdlib.h>
+#include <unistd.h>
+#include <rtthread.h>
+
+#include "soft_wdt.h"
+
+/* 与main.c、wifi_module.c中的截止时间一致 */
+#define SIM_WDT_TIMEOUT_MS  5000
+#define SIM_UI_DEADLINE_MS  5000
+#define SIM_UDP_DEADLINE_MS 3000
+
+/* 原监督线程每100ms轮询一次 */
+#define SIM_POLL_MS         100
+
+soft_wdt_t *g_soft_wdt;
+
+static rt_tick_t expired_tick;
+static rt_tick_t expired_beat;
+static const char *expired_name;
+static rt_uint32_t expired_count;
+
+/* 超时回调：只记录报告时刻，不复位 */
+static void sim_timeout(void *arg)
+{
+    const soft_wdt_channel_t *ch = soft_wdt_expired(g_soft_wdt);
+
+    expired_count++;
+    if (ch && expired_name == RT_NULL) {
+        expired_name = ch->name;
+        expired_beat = ch->last_beat;
+        expired_tick = rt_tick_get();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    rt_uint32_t run_s = 60, ui_ms = 1000, udp_ms = 1000, stall_s = 0, stall_ms = 0;
+    rt_bool_t attach_hw = RT_TRUE;
+    rt_uint32_t end, next_ui, next_udp, stall_from, stall_to;
+    int ui_ch, udp_ch, opt;
+
+    while ((opt = getopt(argc, argv, "t:u:p:s:d:n")) != -1) {
+        switch (opt) {
+        case 't': run_s = atoi(optarg); break;
+        case 'u': ui_ms = atoi(optarg); break;
+        case 'p': udp_ms = atoi(optarg); break;
+        case 's': stall_s = atoi(optarg); break;
+        case 'd': stall_ms = atoi(optarg); break;
+        case 'n': attach_hw = RT_FALSE; break;
+        default:
+            fprintf(stderr, "usage: %s [-t seconds] [-u ui_ms] [-p udp_ms] [-s stall_s] "
+                    "[-d stall_ms] [-n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (run_s == 0 || run_s > 86400 || ui_ms == 0 || udp_ms == 0 || stall_s >= run_s) {
+        fprintf(stderr, "invalid parameters\n");
+        return 1;
+    }
+
+    end = rt_tick_from_millisecond(run_s * 1000);
+    stall_from = stall_s ? rt_tick_from_millisecond(stall_s * 1000) : end;
+    /* 停止到结束时恢复时刻落在结束之后，循环不再发出udp心跳 */
+    stall_to = (stall_s && stall_ms) ? stall_from + rt_tick_from_millisecond(stall_ms) : end + 1;
+
+    rt_host_set_tick(0);
+    g_soft_wdt = soft_wdt_init("soft_wdt", SIM_WDT_TIMEOUT_MS, sim_timeout, RT_NULL);
+    if (g_soft_wdt == RT_NULL) {
+        return 1;
+    }
+    soft_wdt_start(g_soft_wdt);
+    if (attach_hw && soft_wdt_attach_hw(g_soft_wdt, "wdt") != RT_EOK) {
+        return 1;
+    }
+    ui_ch = soft_wdt_register(g_soft_wdt, "ui", SIM_UI_DEADLINE_MS);
+    udp_ch = soft_wdt_register(g_soft_wdt, "udp_recv", SIM_UDP_DEADLINE_MS);
+
+    /* 事件驱动：推进到下一次心跳，其间到期的监督定时器在各自时刻回调 */
+    next_ui = rt_tick_from_millisecond(ui_ms);
+    next_udp = rt_tick_from_millisecond(udp_ms);
+    for (;;) {
+        rt_tick_t now = next_ui < next_udp ? next_ui : next_udp;
+
+        if (now >= stall_from && now < stall_to && next_udp <= next_ui) {
+            /* 停止期间的udp心跳不发生，恢复后按原节奏继续 */
+            next_udp = stall_to;
+            continue;
+        }
+        if (now > end) {
+            break;
+        }
+        rt_host_timer_run(now);
+        if (now == next_ui) {
+            soft_wdt_heartbeat(g_soft_wdt, ui_ch);
+            next_ui += rt_tick_from_millisecond(ui_ms);
+        }
+        if (now == next_udp) {
+            soft_wdt_heartbeat(g_soft_wdt, udp_ch);
+            next_udp += rt_tick_from_millisecond(udp_ms);
+        }
+    }
+    rt_host_timer_run(end);
+
+    soft_wdt_dump(g_soft_wdt);
+    printf("Run      : %u s, ui beat %u ms, udp_recv beat %u ms\n", run_s, ui_ms, udp_ms);
+    printf("Wakeups  : %u timer, %u for a %d ms polling loop\n",
+           g_soft_wdt->wakeups, run_s * 1000 / SIM_POLL_MS, SIM_POLL_MS);
+    if (expired_name) {
+        printf("Expired  : '%s' reported %u ms after its last beat, %u timeouts\n",
+               expired_name, (expired_tick - expired_beat) * 1000 / RT_TICK_PER_SECOND,
+               expired_count);
+    } else {
+        printf("Expired  : none\n");
+    }
+    return 0;
+}